@@ -0,0 +1,2211 @@
+// girth.c
+// Shortest cycle engine (interface: girth.h). Build: make
+
+#define _POSIX_C_SOURCE 200809L   // posix_memalign, mmap, posix_madvise
+#define GIRTH_BUILD
+#include "girth.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define NON_VISITE 0
+#define EN_COURS 1
+#define VISITE 2
+
+#define NO_PARENT UINT32_MAX
+
+#define GIRTH_CHUNK 64        // sources taken at once by a thread of shortestCycleParallel
+#define GIRTH_LANES 64        // sources of one bit-parallel BFS (bits of a uint64_t)
+
+// ============================================================
+//                        ALLOCATION
+// ============================================================
+
+static void *default_alloc(void *user, size_t bytes, size_t align) {
+    (void)user;
+#ifdef _WIN32
+    return _aligned_malloc(bytes, align);
+#else
+    if (align <= 2 * sizeof(void *)) return malloc(bytes);
+    void *p = NULL;
+    if (posix_memalign(&p, align, bytes) != 0) return NULL;
+    return p;
+#endif
+}
+
+static void default_release(void *user, void *p) {
+    (void)user;
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static const GirthAllocator default_allocator = { default_alloc, default_release, NULL };
+
+void *girth_alloc(const GirthAllocator *A, size_t bytes) {
+    if (!A) A = &default_allocator;
+    return A->alloc(A->user, bytes > 0 ? bytes : 1, 2 * sizeof(void *));
+}
+
+void girth_free(const GirthAllocator *A, void *p) {
+    if (!p) return;
+    if (!A) A = &default_allocator;
+    A->release(A->user, p);
+}
+
+// ============================================================
+//              COMPRESSED SPARSE ROW GRAPH
+// ============================================================
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Insertion sort for short rows, qsort beyond
+static void sort_row(uint32_t *a, uint64_t len) {
+    if (len > 32) {
+        qsort(a, (size_t)len, sizeof(uint32_t), cmp_u32);
+        return;
+    }
+    for (uint64_t i = 1; i < len; i++) {
+        uint32_t x = a[i];
+        uint64_t j = i;
+        while (j > 0 && a[j - 1] > x) { a[j] = a[j - 1]; j--; }
+        a[j] = x;
+    }
+}
+
+// Index of v in the row of u (binary search), offsets[u+1] if absent
+static uint64_t csr_find(const CsrGraph *g, uint32_t u, uint32_t v) {
+    uint64_t lo = g->offsets[u], hi = g->offsets[u + 1];
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        if (g->adj[mid] < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo < g->offsets[u + 1] && g->adj[lo] == v ? lo : g->offsets[u + 1];
+}
+
+void csr_free(CsrGraph *g) {
+    if (!g) return;
+    const GirthAllocator *A = g->alloc;
+    girth_free(A, g->offsets);
+    girth_free(A, g->adj);
+    girth_free(A, g->weight);
+    girth_free(A, g);
+}
+
+// ============================================================
+//                      PARALLEL LOOPS
+// ============================================================
+
+// body(ctx, i0, i1) over [0, total), in chunks handed out by an atomic counter. The calling
+// thread takes part; a thread that cannot be started only means less help.
+typedef struct {
+    void (*body)(void *ctx, uint64_t i0, uint64_t i1);
+    void *ctx;
+    uint64_t total, chunk, next;
+} ParallelFor;
+
+static void *pfor_worker(void *arg) {
+    ParallelFor *P = arg;
+    for (;;) {
+        uint64_t i0 = __atomic_fetch_add(&P->next, P->chunk, __ATOMIC_RELAXED);
+        if (i0 >= P->total) break;
+        P->body(P->ctx, i0, i0 + P->chunk < P->total ? i0 + P->chunk : P->total);
+    }
+    return NULL;
+}
+
+static void parallel_for(const GirthAllocator *A, int nthreads, uint64_t total, uint64_t chunk,
+                         void (*body)(void *, uint64_t, uint64_t), void *ctx) {
+    ParallelFor P = { body, ctx, total, chunk, 0 };
+    uint64_t nchunks = (total + chunk - 1) / chunk;
+    if (nthreads < 1) nthreads = 1;
+    if ((uint64_t)nthreads > nchunks) nthreads = nchunks > 0 ? (int)nchunks : 1;
+    pthread_t *th = nthreads > 1 ? girth_alloc(A, (size_t)nthreads * sizeof(pthread_t)) : NULL;
+    int started = 1;
+    if (th)
+        for (int t = 1; t < nthreads; t++)
+            if (pthread_create(&th[started], NULL, pfor_worker, &P) == 0) started++;
+    pfor_worker(&P);
+    for (int t = 1; t < started; t++) pthread_join(th[t], NULL);
+    girth_free(A, th);
+}
+
+// ============================================================
+//                  PARALLEL CSR CONSTRUCTION
+// ============================================================
+
+#define BUILD_CHUNK 65536     // vertices per task of the row sort and of the cursor scan
+
+// Passes 1 and 2 split the edge list into one slice per thread, so each edge is read once per
+// pass. Slice s counts its edges per vertex in its own histogram cnt[s*n + v] (no shared
+// counter, no atomic increment); a scan over (vertex, slice) turns the counts into cursors,
+// slice s writing row v from offsets[v] + (entries of the slices before s). The histograms
+// take slices * n * 4 bytes, so there are at most nedges / n slices: never more memory than
+// the edge list itself.
+typedef struct {
+    CsrGraph *g;
+    const Edge *edges;
+    size_t nedges;
+    int slices;
+    uint32_t *cnt;        // slices * n counters, then cursors
+    uint32_t *len;        // row lengths once repeats are removed
+    int bad;              // an id >= n was seen
+    const uint32_t *weights;   // csr_from_edges_weighted: weight of each edge
+    int directed;         // csr_from_arcs: edge u v in row u only
+} CsrBuild;
+
+static size_t slice_start(const CsrBuild *B, uint64_t s) {
+    size_t q = B->nedges / B->slices, r = B->nedges % B->slices;
+    return q * s + (s < r ? s : r);
+}
+
+// Pass 1: degrees of slice s in its histogram
+static void build_degrees(void *ctx, uint64_t s0, uint64_t s1) {
+    CsrBuild *B = ctx;
+    uint32_t n = B->g->n;
+    for (uint64_t s = s0; s < s1; s++) {
+        uint32_t *cnt = B->cnt + (size_t)s * n;
+        for (size_t e = slice_start(B, s); e < slice_start(B, s + 1); e++) {
+            uint32_t u = B->edges[e].u, v = B->edges[e].v;
+            if (u >= n || v >= n) { __atomic_store_n(&B->bad, 1, __ATOMIC_RELAXED); return; }
+            if (u == v) continue;
+            cnt[u]++;
+            if (!B->directed) cnt[v]++;
+        }
+    }
+}
+
+// Between the passes: cnt[s][v] becomes the position of slice s in row v, offsets[v+1] the
+// length of row v
+static void build_cursors(void *ctx, uint64_t v0, uint64_t v1) {
+    CsrBuild *B = ctx;
+    uint32_t n = B->g->n;
+    for (uint64_t v = v0; v < v1; v++) {
+        uint32_t sum = 0;
+        for (int s = 0; s < B->slices; s++) {
+            uint32_t c = B->cnt[(size_t)s * n + v];
+            B->cnt[(size_t)s * n + v] = sum;
+            sum += c;
+        }
+        B->g->offsets[v + 1] = sum;
+    }
+}
+
+// Pass 2: slice s places its edges at its cursors
+static void build_place(void *ctx, uint64_t s0, uint64_t s1) {
+    CsrBuild *B = ctx;
+    const uint64_t *off = B->g->offsets;
+    uint32_t *adj = B->g->adj;
+    uint32_t n = B->g->n;
+    for (uint64_t s = s0; s < s1; s++) {
+        uint32_t *cur = B->cnt + (size_t)s * n;
+        for (size_t e = slice_start(B, s); e < slice_start(B, s + 1); e++) {
+            uint32_t u = B->edges[e].u, v = B->edges[e].v;
+            if (u == v) continue;
+            adj[off[u] + cur[u]++] = v;
+            if (!B->directed) adj[off[v] + cur[v]++] = u;
+        }
+    }
+}
+
+// Pass 3: each row sorted and its repeats removed in place; len[v] is its new length
+static void build_rows(void *ctx, uint64_t v0, uint64_t v1) {
+    CsrBuild *B = ctx;
+    const uint64_t *off = B->g->offsets;
+    uint32_t *adj = B->g->adj;
+    for (uint64_t v = v0; v < v1; v++) {
+        uint64_t s = off[v], e = off[v + 1], w = s;
+        sort_row(adj + s, e - s);
+        for (uint64_t i = s; i < e; i++)
+            if (i == s || adj[i] != adj[i - 1]) adj[w++] = adj[i];
+        B->len[v] = (uint32_t)(w - s);
+    }
+}
+
+// Weights, same slices as the placement: each entry keeps the smallest weight given to it.
+// An edge repeated in two slices reaches the same entry from two threads: minimum by
+// compare-and-swap (one exchange per entry otherwise).
+static void weight_min(uint32_t *slot, uint32_t w) {
+    uint32_t old = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    while (w < old && !__atomic_compare_exchange_n(slot, &old, w, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) ;
+}
+
+static void build_weights(void *ctx, uint64_t s0, uint64_t s1) {
+    CsrBuild *B = ctx;
+    const CsrGraph *g = B->g;
+    for (uint64_t s = s0; s < s1; s++)
+        for (size_t e = slice_start(B, s); e < slice_start(B, s + 1); e++) {
+            uint32_t u = B->edges[e].u, v = B->edges[e].v;
+            if (u == v) continue;
+            weight_min(&g->weight[csr_find(g, u, v)], B->weights[e]);
+            weight_min(&g->weight[csr_find(g, v, u)], B->weights[e]);
+        }
+}
+
+// Number of edge slices for nthreads threads (see CsrBuild)
+static int build_slices(uint32_t n, size_t nedges, int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+    size_t most = n > 0 ? nedges / n : 1;
+    if (most < 1) most = 1;
+    return (size_t)nthreads < most ? nthreads : (int)most;
+}
+
+static CsrGraph *csr_build(const GirthAllocator *A, uint32_t n, const Edge *edges,
+                           size_t nedges, int nthreads, int directed) {
+    if (nthreads < 1) nthreads = 1;
+    int slices = build_slices(n, nedges, nthreads);
+    CsrGraph *g = girth_alloc(A, sizeof(CsrGraph));
+    if (!g) return NULL;
+    g->n = n;
+    g->m = 0;
+    g->alloc = A;
+    g->adj = NULL;
+    g->weight = NULL;
+    g->offsets = girth_alloc(A, ((size_t)n + 1) * sizeof(uint64_t));
+    uint32_t *len = girth_alloc(A, (size_t)(n > 0 ? n : 1) * sizeof(uint32_t));
+    uint32_t *cnt = girth_alloc(A, (size_t)slices * (n > 0 ? n : 1) * sizeof(uint32_t));
+    CsrBuild B = { g, edges, nedges, slices, cnt, len, 0, NULL, directed };
+    if (!g->offsets || !len || !cnt) goto fail;
+    memset(cnt, 0, (size_t)slices * n * sizeof(uint32_t));
+
+    uint64_t *off = g->offsets;
+    parallel_for(A, nthreads, slices, 1, build_degrees, &B);
+    if (B.bad) goto fail;
+    off[0] = 0;
+    parallel_for(A, nthreads, n, BUILD_CHUNK, build_cursors, &B);
+    for (uint32_t v = 0; v < n; v++) off[v + 1] += off[v];
+
+    g->adj = girth_alloc(A, (size_t)off[n] * sizeof(uint32_t));
+    if (!g->adj) goto fail;
+    parallel_for(A, nthreads, slices, 1, build_place, &B);
+    girth_free(A, cnt);
+    cnt = NULL;
+
+    parallel_for(A, nthreads, n, BUILD_CHUNK, build_rows, &B);
+
+    // Rows moved down over the removed repeats, in order (a row never moves up)
+    uint64_t w = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        uint64_t s = off[v];
+        off[v] = w;
+        if (w != s) memmove(g->adj + w, g->adj + s, (size_t)len[v] * sizeof(uint32_t));
+        w += len[v];
+    }
+    off[n] = w;
+    g->m = w;
+    girth_free(A, len);
+    return g;
+
+fail:
+    girth_free(A, len);
+    girth_free(A, cnt);
+    csr_free(g);
+    return NULL;
+}
+
+CsrGraph *csr_from_edges_parallel(const GirthAllocator *A, uint32_t n, const Edge *edges,
+                                  size_t nedges, int nthreads) {
+    return csr_build(A, n, edges, nedges, nthreads, 0);
+}
+
+CsrGraph *csr_from_edges(const GirthAllocator *A, uint32_t n, const Edge *edges, size_t nedges) {
+    return csr_build(A, n, edges, nedges, 1, 0);
+}
+
+CsrGraph *csr_from_arcs(const GirthAllocator *A, uint32_t n, const Edge *edges, size_t nedges,
+                        int nthreads) {
+    return csr_build(A, n, edges, nedges, nthreads, 1);
+}
+
+// The rows first (same as unweighted), then one more pass over the edges placing each weight
+// at its two entries, found by binary search in the sorted rows
+CsrGraph *csr_from_edges_weighted(const GirthAllocator *A, uint32_t n, const Edge *edges,
+                                  const uint32_t *weights, size_t nedges, int nthreads) {
+    CsrGraph *g = csr_from_edges_parallel(A, n, edges, nedges, nthreads);
+    if (!g) return NULL;
+    g->weight = girth_alloc(A, (size_t)(g->m > 0 ? g->m : 1) * sizeof(uint32_t));
+    if (!g->weight) {
+        csr_free(g);
+        return NULL;
+    }
+    for (uint64_t k = 0; k < g->m; k++) g->weight[k] = UINT32_MAX;
+    int slices = nthreads < 1 ? 1 : nthreads;
+    CsrBuild B = { g, edges, nedges, slices, NULL, NULL, 0, weights, 0 };
+    parallel_for(A, nthreads, slices, 1, build_weights, &B);
+    return g;
+}
+
+// ============================================================
+//                       EDGE-LIST FILES
+// ============================================================
+
+#define LOAD_CHUNK ((size_t)1 << 22)   // bytes of text per parsing task
+#define REMAP_CHUNK 65536              // edges (or bitmap words) per renumbering task
+#define BINARY_HEADER 16               // magic + number of edges
+
+// Private writable mapping: a binary file is renumbered in place without touching the file
+// (pages are copied only when written)
+typedef struct {
+    unsigned char *data;   // NULL for an empty file
+    size_t size;
+} MappedFile;
+
+static int map_file(const char *path, MappedFile *f) {
+    f->data = NULL;
+    f->size = 0;
+#ifdef _WIN32
+    HANDLE h = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (h == INVALID_HANDLE_VALUE) return GIRTH_IO_FILE;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(h, &sz)) { CloseHandle(h); return GIRTH_IO_FILE; }
+    f->size = (size_t)sz.QuadPart;
+    if (f->size > 0) {
+        HANDLE m = CreateFileMappingA(h, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (m) {
+            f->data = MapViewOfFile(m, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(m);   // the view keeps the mapping alive
+        }
+    }
+    CloseHandle(h);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return GIRTH_IO_FILE;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return GIRTH_IO_FILE; }
+    f->size = (size_t)st.st_size;
+    if (f->size > 0) {
+        void *p = mmap(NULL, f->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            f->data = p;
+            posix_madvise(p, f->size, POSIX_MADV_SEQUENTIAL);
+        }
+    }
+    close(fd);
+#endif
+    return f->size > 0 && !f->data ? GIRTH_IO_FILE : GIRTH_IO_OK;
+}
+
+static void unmap_file(MappedFile *f) {
+    if (!f->data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(f->data);
+#else
+    munmap(f->data, f->size);
+#endif
+}
+
+static uint32_t get_le32(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void put_le32(unsigned char *p, uint32_t x) {
+    p[0] = (unsigned char)x;
+    p[1] = (unsigned char)(x >> 8);
+    p[2] = (unsigned char)(x >> 16);
+    p[3] = (unsigned char)(x >> 24);
+}
+
+// --- Text ---
+
+// The file is cut into LOAD_CHUNK pieces, each moved forward to the start of a line. Pass 1
+// counts the lines of each piece, which bounds its edges and gives each one its slots in the
+// edge array; pass 2 parses every piece into its slots.
+typedef struct {
+    const char *text;
+    size_t size;
+    uint64_t *lines;      // per piece: lines, then (prefix sums) lines before it
+    uint64_t *count;      // per piece: edges parsed
+    uint64_t *badLine;    // per piece: first bad line counted from the piece (0: none)
+    uint32_t *maxId;      // per piece
+    Edge *edges;
+    uint32_t *weights;    // weighted file: third column, same slots as edges (NULL otherwise)
+} TextLoad;
+
+static size_t piece_start(const TextLoad *T, uint64_t c) {
+    if (c == 0) return 0;
+    size_t p = (size_t)c * LOAD_CHUNK - 1;
+    if (p >= T->size) return T->size;
+    const char *nl = memchr(T->text + p, '\n', T->size - p);
+    return nl ? (size_t)(nl - T->text) + 1 : T->size;
+}
+
+static void text_count(void *ctx, uint64_t c0, uint64_t c1) {
+    TextLoad *T = ctx;
+    for (uint64_t c = c0; c < c1; c++) {
+        size_t s = piece_start(T, c), e = piece_start(T, c + 1);
+        uint64_t k = 0;
+        const char *p = T->text + s, *end = T->text + e;
+        while (p < end && (p = memchr(p, '\n', (size_t)(end - p))) != NULL) { k++; p++; }
+        if (e > s && T->text[e - 1] != '\n') k++;
+        T->lines[c] = k;
+    }
+}
+
+// Unsigned 32-bit decimal at p; NULL if there is no digit or the value overflows
+static const char *scan_u32(const char *p, const char *end, uint32_t *x) {
+    if (p == end || (unsigned)(*p - '0') > 9) return NULL;
+    uint64_t v = 0;
+    do {
+        v = v * 10 + (unsigned)(*p - '0');
+        if (v > UINT32_MAX) return NULL;
+        p++;
+    } while (p < end && (unsigned)(*p - '0') <= 9);
+    *x = (uint32_t)v;
+    return p;
+}
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static void text_parse(void *ctx, uint64_t c0, uint64_t c1) {
+    TextLoad *T = ctx;
+    for (uint64_t c = c0; c < c1; c++) {
+        const char *p = T->text + piece_start(T, c), *end = T->text + piece_start(T, c + 1);
+        Edge *out = T->edges + T->lines[c];
+        uint64_t k = 0, line = 0;
+        uint32_t mx = 0;
+        T->badLine[c] = 0;
+        while (p < end) {
+            line++;
+            while (p < end && is_blank(*p)) p++;
+            if (p < end && (unsigned)(*p - '0') <= 9) {
+                uint32_t u, v;
+                p = scan_u32(p, end, &u);
+                while (p && p < end && (is_blank(*p) || *p == ',')) p++;
+                p = p ? scan_u32(p, end, &v) : NULL;
+                uint32_t w = 0;
+                if (p && T->weights) {
+                    while (p < end && (is_blank(*p) || *p == ',')) p++;
+                    p = scan_u32(p, end, &w);
+                }
+                if (!p || (p < end && !is_blank(*p) && *p != ',' && *p != '\r' && *p != '\n')) {
+                    T->badLine[c] = line;
+                    break;
+                }
+                out[k].u = u;
+                out[k].v = v;
+                if (T->weights) T->weights[T->lines[c] + k] = w;
+                k++;
+                if (u > mx) mx = u;
+                if (v > mx) mx = v;
+            } else if (p < end && *p != '\n' && *p != '\r' && *p != '#' && *p != '%') {
+                T->badLine[c] = line;
+                break;
+            }
+            // Rest of the line ignored
+            if (p < end && *p == '\n') { p++; continue; }
+            const char *nl = memchr(p, '\n', (size_t)(end - p));
+            p = nl ? nl + 1 : end;
+        }
+        T->count[c] = k;
+        T->maxId[c] = mx;
+    }
+}
+
+// Edge array of the file (info->records edges), NULL with info->status set on failure.
+// With weights != NULL every line needs a third column, returned in *weights.
+static Edge *load_text(const GirthAllocator *A, const MappedFile *f, int nthreads,
+                       uint32_t **weights, GirthLoadInfo *info) {
+    TextLoad T;
+    uint64_t npieces = (f->size + LOAD_CHUNK - 1) / LOAD_CHUNK;
+    size_t np = (size_t)(npieces > 0 ? npieces : 1);
+    T.text = (const char *)f->data;
+    T.size = f->size;
+    T.lines = girth_alloc(A, np * sizeof(uint64_t));
+    T.count = girth_alloc(A, np * sizeof(uint64_t));
+    T.badLine = girth_alloc(A, np * sizeof(uint64_t));
+    T.maxId = girth_alloc(A, np * sizeof(uint32_t));
+    T.edges = NULL;
+    T.weights = NULL;
+    info->status = GIRTH_IO_NOMEM;
+    if (T.lines && T.count && T.badLine && T.maxId) {
+        parallel_for(A, nthreads, npieces, 1, text_count, &T);
+        uint64_t total = 0;
+        for (uint64_t c = 0; c < npieces; c++) {
+            uint64_t k = T.lines[c];
+            T.lines[c] = total;
+            total += k;
+        }
+        T.edges = girth_alloc(A, (size_t)total * sizeof(Edge));
+        if (weights) T.weights = girth_alloc(A, (size_t)total * sizeof(uint32_t));
+    }
+    if (T.edges && (!weights || T.weights)) {
+        parallel_for(A, nthreads, npieces, 1, text_parse, &T);
+        // Pieces moved down over the slots of skipped lines, in order
+        uint64_t w = 0;
+        info->status = GIRTH_IO_OK;
+        for (uint64_t c = 0; c < npieces; c++) {
+            if (T.badLine[c]) {
+                info->status = GIRTH_IO_FORMAT;
+                info->line = T.lines[c] + T.badLine[c];
+                break;
+            }
+            if (w != T.lines[c]) {
+                memmove(T.edges + w, T.edges + T.lines[c], (size_t)T.count[c] * sizeof(Edge));
+                if (T.weights)
+                    memmove(T.weights + w, T.weights + T.lines[c],
+                            (size_t)T.count[c] * sizeof(uint32_t));
+            }
+            w += T.count[c];
+            if (T.maxId[c] > info->maxId) info->maxId = T.maxId[c];
+        }
+        info->records = w;
+    }
+    girth_free(A, T.lines);
+    girth_free(A, T.count);
+    girth_free(A, T.badLine);
+    girth_free(A, T.maxId);
+    if (info->status != GIRTH_IO_OK) {
+        girth_free(A, T.edges);
+        girth_free(A, T.weights);
+        return NULL;
+    }
+    if (weights) *weights = T.weights;
+    return T.edges;
+}
+
+// --- Binary ---
+
+typedef struct {
+    Edge *edges;
+    uint32_t *maxId;      // per task
+} BinaryLoad;
+
+// Records converted in place to host order (a no-op on little-endian machines)
+static void binary_scan(void *ctx, uint64_t e0, uint64_t e1) {
+    BinaryLoad *L = ctx;
+    uint32_t mx = 0;
+    for (uint64_t e = e0; e < e1; e++) {
+        unsigned char *r = (unsigned char *)&L->edges[e];
+        uint32_t u = get_le32(r), v = get_le32(r + 4);
+        L->edges[e].u = u;
+        L->edges[e].v = v;
+        if (u > mx) mx = u;
+        if (v > mx) mx = v;
+    }
+    L->maxId[e0 / REMAP_CHUNK] = mx;
+}
+
+// Edges of the file, in place in the mapping
+static Edge *load_binary(const GirthAllocator *A, const MappedFile *f, int nthreads,
+                         GirthLoadInfo *info) {
+    uint64_t nedges = 0;
+    for (int i = 7; i >= 0; i--) nedges = nedges << 8 | f->data[8 + i];
+    if (nedges != (f->size - BINARY_HEADER) / sizeof(Edge) ||
+        (f->size - BINARY_HEADER) % sizeof(Edge) != 0) {
+        info->status = GIRTH_IO_FORMAT;
+        return NULL;
+    }
+    BinaryLoad L = { (Edge *)(f->data + BINARY_HEADER), NULL };
+    uint64_t ntasks = (nedges + REMAP_CHUNK - 1) / REMAP_CHUNK;
+    L.maxId = girth_alloc(A, (size_t)(ntasks > 0 ? ntasks : 1) * sizeof(uint32_t));
+    if (!L.maxId) { info->status = GIRTH_IO_NOMEM; return NULL; }
+    parallel_for(A, nthreads, nedges, REMAP_CHUNK, binary_scan, &L);
+    for (uint64_t t = 0; t < ntasks; t++)
+        if (L.maxId[t] > info->maxId) info->maxId = L.maxId[t];
+    girth_free(A, L.maxId);
+    info->records = nedges;
+    return L.edges;
+}
+
+// --- Renumbering ---
+
+// Ids up to a few times the number of edges: bitmap of the ids present, word[x/64].bits bit
+// x%64; word[w].base is the new id of the first id present in word w, so the new id of x is
+// its word's base plus the ids present before it in the word (one cache line per lookup).
+// Sparser ids: sorted array of the distinct ids (sorted); the ids whose high bits are b
+// (x >> shift == b) are sorted[dir[b] .. dir[b+1]-1], with about one id per value of b, and
+// the new id of x is found by binary search in that slice.
+typedef struct {
+    uint64_t bits;
+    uint64_t base;
+} IdWord;
+
+typedef struct {
+    Edge *edges;
+    IdWord *word;
+    uint32_t *sorted;
+    uint32_t *dir;
+    int shift;            // 32 at most (ids shifted as 64-bit values)
+    uint32_t *ids;
+    int atomic;
+} Remap;
+
+static void remap_mark(void *ctx, uint64_t e0, uint64_t e1) {
+    Remap *R = ctx;
+    for (uint64_t e = e0; e < e1; e++) {
+        uint32_t x[2] = { R->edges[e].u, R->edges[e].v };
+        for (int i = 0; i < 2; i++) {
+            uint64_t bit = (uint64_t)1 << (x[i] & 63);
+            uint64_t *w = &R->word[x[i] >> 6].bits;
+            if (!R->atomic) *w |= bit;
+            else if (!(__atomic_load_n(w, __ATOMIC_RELAXED) & bit))
+                __atomic_fetch_or(w, bit, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static uint32_t remap_id(const Remap *R, uint32_t x) {
+    if (R->sorted) {
+        uint64_t b = (uint64_t)x >> R->shift;
+        uint32_t lo = R->dir[b], hi = R->dir[b + 1];
+        while (hi - lo > 1) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (R->sorted[mid] <= x) lo = mid;
+            else hi = mid;
+        }
+        return lo;
+    }
+    const IdWord *w = &R->word[x >> 6];
+    uint64_t below = w->bits & (((uint64_t)1 << (x & 63)) - 1);
+    return (uint32_t)w->base + (uint32_t)__builtin_popcountll(below);
+}
+
+static void remap_edges(void *ctx, uint64_t e0, uint64_t e1) {
+    Remap *R = ctx;
+    for (uint64_t e = e0; e < e1; e++) {
+        R->edges[e].u = remap_id(R, R->edges[e].u);
+        R->edges[e].v = remap_id(R, R->edges[e].v);
+    }
+}
+
+static void remap_list(void *ctx, uint64_t w0, uint64_t w1) {
+    Remap *R = ctx;
+    for (uint64_t w = w0; w < w1; w++) {
+        uint32_t k = (uint32_t)R->word[w].base;
+        for (uint64_t b = R->word[w].bits; b; b &= b - 1)
+            R->ids[k++] = (uint32_t)(w * 64 + (uint64_t)__builtin_ctzll(b));
+    }
+}
+
+// LSD radix sort, 8 bits per pass; the result is back in a
+static void radix_sort_u32(uint32_t *a, uint32_t *tmp, uint64_t len) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        uint64_t start[257] = { 0 };
+        for (uint64_t i = 0; i < len; i++) start[((a[i] >> shift) & 255) + 1]++;
+        for (int d = 0; d < 256; d++) start[d + 1] += start[d];
+        for (uint64_t i = 0; i < len; i++) tmp[start[(a[i] >> shift) & 255]++] = a[i];
+        uint32_t *t = a; a = tmp; tmp = t;
+    }
+}
+
+// Bitmap (dense) or sorted (sparse) form of the ids present; the number of distinct ids, or
+// UINT64_MAX when memory is short
+static uint64_t remap_prepare(const GirthAllocator *A, Remap *R, uint64_t records,
+                              uint32_t maxId, int nthreads) {
+    uint64_t nwords = records > 0 ? (uint64_t)maxId / 64 + 1 : 0;
+    uint64_t n = 0;
+    if (nwords * sizeof(IdWord) > records * 2 * sizeof(Edge)) {
+        uint32_t *tmp = girth_alloc(A, (size_t)records * 2 * sizeof(uint32_t));
+        R->sorted = girth_alloc(A, (size_t)records * 2 * sizeof(uint32_t));
+        if (!tmp || !R->sorted) { girth_free(A, tmp); return UINT64_MAX; }
+        memcpy(R->sorted, R->edges, (size_t)records * sizeof(Edge));
+        radix_sort_u32(R->sorted, tmp, 2 * records);
+        girth_free(A, tmp);
+        for (uint64_t i = 0; i < 2 * records; i++)
+            if (i == 0 || R->sorted[i] != R->sorted[i - 1]) R->sorted[n++] = R->sorted[i];
+        // Smallest shift giving at most n slices (n < 2^32)
+        R->shift = 32;
+        while (R->shift > 0 && ((uint64_t)1 << (32 - R->shift + 1)) <= n) R->shift--;
+        uint64_t nb = ((uint64_t)UINT32_MAX >> R->shift) + 1;
+        R->dir = girth_alloc(A, (size_t)(nb + 1) * sizeof(uint32_t));
+        if (!R->dir) return UINT64_MAX;
+        uint64_t i = 0;
+        for (uint64_t b = 0; b <= nb; b++) {
+            while (i < n && ((uint64_t)R->sorted[i] >> R->shift) < b) i++;
+            R->dir[b] = (uint32_t)i;
+        }
+        return n;
+    }
+    R->word = girth_alloc(A, (size_t)(nwords > 0 ? nwords : 1) * sizeof(IdWord));
+    if (!R->word) return UINT64_MAX;
+    memset(R->word, 0, (size_t)nwords * sizeof(IdWord));
+    parallel_for(A, nthreads, records, REMAP_CHUNK, remap_mark, R);
+    for (uint64_t w = 0; w < nwords; w++) {
+        R->word[w].base = n;
+        n += (uint64_t)__builtin_popcountll(R->word[w].bits);
+    }
+    return n;
+}
+
+// weighted: text files only, read with their third column; directed: built by csr_from_arcs
+static CsrGraph *load_graph(const GirthAllocator *A, const char *path, int nthreads,
+                            uint32_t **ids, GirthLoadInfo *info, int weighted, int directed) {
+    GirthLoadInfo local;
+    if (!info) info = &local;
+    memset(info, 0, sizeof(*info));
+    if (ids) *ids = NULL;
+
+    MappedFile f;
+    info->status = map_file(path, &f);
+    if (info->status != GIRTH_IO_OK) return NULL;
+    info->bytes = f.size;
+
+    int binary = f.size >= BINARY_HEADER && memcmp(f.data, GIRTH_BINARY_MAGIC, 8) == 0;
+    uint32_t *weights = NULL;
+    Edge *edges = NULL;
+    if (binary && weighted) info->status = GIRTH_IO_FORMAT;
+    else if (binary) edges = load_binary(A, &f, nthreads, info);
+    else edges = load_text(A, &f, nthreads, weighted ? &weights : NULL, info);
+    CsrGraph *g = NULL;
+    Remap R = { edges, NULL, NULL, NULL, 0, NULL, nthreads > 1 };
+    if (info->status != GIRTH_IO_OK) goto done;
+
+    info->status = GIRTH_IO_NOMEM;
+    uint64_t n = remap_prepare(A, &R, info->records, info->maxId, nthreads);
+    if (n == UINT64_MAX) goto done;
+    // Ids already dense (0..maxId all present): nothing to renumber
+    if (info->records > 0 && n != (uint64_t)info->maxId + 1)
+        parallel_for(A, nthreads, info->records, REMAP_CHUNK, remap_edges, &R);
+    if (ids && R.sorted) {
+        R.ids = R.sorted;
+        R.sorted = NULL;
+    } else if (ids) {
+        R.ids = girth_alloc(A, (size_t)(n > 0 ? n : 1) * sizeof(uint32_t));
+        if (!R.ids) goto done;
+        uint64_t nwords = info->records > 0 ? (uint64_t)info->maxId / 64 + 1 : 0;
+        parallel_for(A, nthreads, nwords, REMAP_CHUNK, remap_list, &R);
+    }
+
+    if (weighted)
+        g = csr_from_edges_weighted(A, (uint32_t)n, edges, weights, (size_t)info->records,
+                                    nthreads);
+    else
+        g = csr_build(A, (uint32_t)n, edges, (size_t)info->records, nthreads, directed);
+    if (g) {
+        info->status = GIRTH_IO_OK;
+        if (ids) *ids = R.ids;
+        R.ids = NULL;
+    }
+
+done:
+    girth_free(A, R.word);
+    girth_free(A, R.sorted);
+    girth_free(A, R.dir);
+    girth_free(A, R.ids);
+    girth_free(A, weights);
+    if (!binary) girth_free(A, edges);
+    unmap_file(&f);
+    return g;
+}
+
+CsrGraph *csr_load(const GirthAllocator *A, const char *path, int nthreads, uint32_t **ids,
+                   GirthLoadInfo *info) {
+    return load_graph(A, path, nthreads, ids, info, 0, 0);
+}
+
+CsrGraph *csr_load_weighted(const GirthAllocator *A, const char *path, int nthreads,
+                            uint32_t **ids, GirthLoadInfo *info) {
+    return load_graph(A, path, nthreads, ids, info, 1, 0);
+}
+
+CsrGraph *csr_load_directed(const GirthAllocator *A, const char *path, int nthreads,
+                            uint32_t **ids, GirthLoadInfo *info) {
+    return load_graph(A, path, nthreads, ids, info, 0, 1);
+}
+
+int csr_save_binary(const CsrGraph *g, const char *path, const uint32_t *ids) {
+    FILE *out = fopen(path, "wb");
+    if (!out) return GIRTH_IO_FILE;
+    unsigned char buf[4096 * sizeof(Edge)];
+    uint64_t nedges = g->m / 2;
+    memcpy(buf, GIRTH_BINARY_MAGIC, 8);
+    for (int i = 0; i < 8; i++) buf[8 + i] = (unsigned char)(nedges >> (8 * i));
+    int ok = fwrite(buf, 1, BINARY_HEADER, out) == BINARY_HEADER;
+    size_t k = 0;
+    for (uint32_t v = 0; ok && v < g->n; v++) {
+        for (uint64_t e = g->offsets[v]; e < g->offsets[v + 1]; e++) {
+            uint32_t w = g->adj[e];
+            if (w <= v) continue;   // each edge from its smaller end
+            put_le32(buf + k, ids ? ids[v] : v);
+            put_le32(buf + k + 4, ids ? ids[w] : w);
+            k += sizeof(Edge);
+            if (k == sizeof(buf)) {
+                ok = fwrite(buf, 1, k, out) == k;
+                k = 0;
+                if (!ok) break;
+            }
+        }
+    }
+    if (ok && k > 0) ok = fwrite(buf, 1, k, out) == k;
+    if (fclose(out) != 0) ok = 0;
+    return ok ? GIRTH_IO_OK : GIRTH_IO_FILE;
+}
+
+// ============================================================
+//                      SHORTEST CYCLE
+// ============================================================
+
+// BFS buffers, allocated once and reused for every source. Between two searches every
+// vertex is back to NON_VISITE / INF / NO_PARENT: each BFS resets only what it touched
+// (the vertices of its queue), so a search stopped early costs only what it explored.
+typedef struct {
+    uint8_t *etat;
+    int *distance;
+    uint32_t *parent;
+    uint32_t *queue;
+} BfsWork;
+
+static void work_free(const CsrGraph *g, BfsWork *W) {
+    girth_free(g->alloc, W->etat);
+    girth_free(g->alloc, W->distance);
+    girth_free(g->alloc, W->parent);
+    girth_free(g->alloc, W->queue);
+}
+
+static int work_init(const CsrGraph *g, BfsWork *W) {
+    size_t n = g->n > 0 ? g->n : 1;
+    W->etat = girth_alloc(g->alloc, n * sizeof(uint8_t));
+    W->distance = girth_alloc(g->alloc, n * sizeof(int));
+    W->parent = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    W->queue = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    if (!W->etat || !W->distance || !W->parent || !W->queue) {
+        work_free(g, W);
+        return 0;
+    }
+    for (uint32_t i = 0; i < g->n; i++) {
+        W->etat[i] = NON_VISITE;
+        W->distance[i] = INF;
+        W->parent[i] = NO_PARENT;
+    }
+    return 1;
+}
+
+// Cycle closed by the edge v-w in the BFS tree of W: the two parent chains climbed up to their
+// lowest common ancestor x, giving x .. v w .. (child of x), a simple cycle (the chains only
+// meet at x). Its length is distance[v]+distance[w]+1 when x is the source, which holds for a
+// shortest cycle (otherwise the cycle through x would be shorter). Returns its length.
+static int trace_cycle(const BfsWork *W, uint32_t v, uint32_t w, uint32_t *cycle) {
+    const int *distance = W->distance;
+    const uint32_t *parent = W->parent;
+    int dl = 0, dr = 0;     // edges from v, from w, up to x
+    uint32_t a = v, b = w;
+    while (distance[a] > distance[b]) { a = parent[a]; dl++; }
+    while (distance[b] > distance[a]) { b = parent[b]; dr++; }
+    while (a != b) { a = parent[a]; b = parent[b]; dl++; dr++; }
+    cycle[0] = a;
+    a = v;
+    for (int i = dl; i > 0; i--) { cycle[i] = a; a = parent[a]; }
+    b = w;
+    for (int i = 0; i < dr; i++) { cycle[dl + 1 + i] = b; b = parent[b]; }
+    return dl + dr + 1;
+}
+
+// BFS from s looking only for cycles shorter than bound. A cycle closed while v (at depth d)
+// is being expanded has length >= 2d+1, and depths never decrease along the queue: the search
+// stops as soon as 2*distance[v]+1 reaches the best length known (bound or found here).
+// With rank != NULL, vertices ranked before s are ignored (their cycles are already counted).
+// With shared != NULL, the bound is refreshed from *shared (best of all threads) at each level.
+// With witness != NULL, the cycle found is written there (see trace_cycle).
+// With odd, only edges inside a level close a cycle (see shortestOddCycle).
+// Returns the shortest length found (INF if none).
+static int bfs_cycle_work(const CsrGraph *g, BfsWork *W, uint32_t s, const uint32_t *rank,
+                          int bound, const int *shared, uint32_t *witness, int odd) {
+    uint8_t *etat = W->etat;
+    int *distance = W->distance;
+    uint32_t *parent = W->parent;
+    uint32_t *queue = W->queue;
+    const uint64_t *off = g->offsets;
+    const uint32_t *adj = g->adj;
+    uint32_t head = 0, tail = 0;
+    uint32_t rs = rank ? rank[s] : 0;
+
+    etat[s] = EN_COURS;
+    distance[s] = 0;
+    queue[tail++] = s;
+
+    int best = INF;
+    int limit = bound;
+    int level = 0;
+    uint32_t cv = NO_PARENT, cw = NO_PARENT;   // closing edge of best
+
+    while (head < tail) {
+        uint32_t v = queue[head++];
+        if (shared && distance[v] != level) {
+            level = distance[v];
+            int b = __atomic_load_n(shared, __ATOMIC_RELAXED);
+            if (b < limit) limit = b;
+        }
+        if (2 * distance[v] + 1 >= limit) break;
+        for (uint64_t k = off[v]; k < off[v + 1]; k++) {
+            uint32_t w = adj[k];
+            if (rank && rank[w] < rs) continue;
+
+            if (etat[w] == NON_VISITE) {
+                etat[w] = EN_COURS;
+                distance[w] = distance[v] + 1;
+                parent[w] = v;
+                queue[tail++] = w;
+            }
+            else if (etat[w] == EN_COURS && (odd ? distance[w] == distance[v] : parent[v] != w)) {
+                int cycle_length = distance[v] + distance[w] + 1;
+                if (cycle_length < best) {
+                    best = cycle_length;
+                    cv = v;
+                    cw = w;
+                }
+                if (cycle_length < limit)
+                    limit = cycle_length;
+            }
+        }
+        etat[v] = VISITE;
+    }
+    if (witness && best < INF) trace_cycle(W, cv, cw, witness);
+
+    for (uint32_t i = 0; i < tail; i++) {
+        uint32_t u = queue[i];
+        etat[u] = NON_VISITE;
+        distance[u] = INF;
+        parent[u] = NO_PARENT;
+    }
+    return best;
+}
+
+// Shortest directed cycle through s: BFS along the arcs until one leads back to s, closing a
+// cycle of length distance[v]+1 (the first one found is the shortest). Same rank / bound /
+// shared conventions as bfs_cycle_work.
+static int bfs_directed_work(const CsrGraph *g, BfsWork *W, uint32_t s, const uint32_t *rank,
+                             int bound, const int *shared) {
+    uint8_t *etat = W->etat;
+    int *distance = W->distance;
+    uint32_t *queue = W->queue;
+    const uint64_t *off = g->offsets;
+    const uint32_t *adj = g->adj;
+    uint32_t head = 0, tail = 0;
+    uint32_t rs = rank ? rank[s] : 0;
+
+    etat[s] = EN_COURS;
+    distance[s] = 0;
+    queue[tail++] = s;
+
+    int best = INF;
+    int limit = bound;
+    int level = 0;
+
+    while (head < tail && best == INF) {
+        uint32_t v = queue[head++];
+        if (shared && distance[v] != level) {
+            level = distance[v];
+            int b = __atomic_load_n(shared, __ATOMIC_RELAXED);
+            if (b < limit) limit = b;
+        }
+        if (distance[v] + 1 >= limit) break;
+        for (uint64_t k = off[v]; k < off[v + 1]; k++) {
+            uint32_t w = adj[k];
+            if (w == s) {
+                best = distance[v] + 1;
+                break;
+            }
+            if (rank && rank[w] < rs) continue;
+            if (etat[w] == NON_VISITE) {
+                etat[w] = EN_COURS;
+                distance[w] = distance[v] + 1;
+                queue[tail++] = w;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < tail; i++) {
+        uint32_t u = queue[i];
+        etat[u] = NON_VISITE;
+        distance[u] = INF;
+    }
+    return best;
+}
+
+int BFS_cycle(const CsrGraph *g, uint32_t s) {
+    BfsWork W;
+    if (!work_init(g, &W)) return GIRTH_NOMEM;
+    int best = bfs_cycle_work(g, &W, s, NULL, INF, NULL, NULL, 0);
+    work_free(g, &W);
+    return best;
+}
+
+// ============================================================
+//              BIT-PARALLEL MULTI-SOURCE BFS
+// ============================================================
+
+// Up to 64 BFS run together, one bit (lane) per source: for every vertex, seen / frontier /
+// next are the lanes that reached it, that have it on the current level, and that reach it
+// on the next one. A level scans each frontier vertex's row once for all its lanes, so the
+// edge array is read up to 64 times less often than with one BFS per source.
+//
+// Without per-lane parents, closures are detected level by level, for lane s at level k:
+//   - an edge between two vertices of level k closes a walk of length 2k+1;
+//   - a vertex reached at level k+1 from two vertices of level k closes one of length 2k+2.
+// Both walks contain a cycle at most that long, and from a vertex of a shortest cycle the
+// first closure is exactly that cycle, so the minimum over all sources is the girth.
+// The three masks of a vertex are stored together: one cache line per neighbor visited.
+typedef struct {
+    uint64_t seen, frontier, next;
+} LaneMasks;
+
+typedef struct {
+    LaneMasks *mask;
+    uint32_t *cur, *nxt;       // vertices of the current / next level (each at most once)
+    uint32_t *touched;         // vertices with seen != 0, reset after the batch
+} MsbfsWork;
+
+static void msbfs_free(const CsrGraph *g, MsbfsWork *M) {
+    girth_free(g->alloc, M->mask);
+    girth_free(g->alloc, M->cur);
+    girth_free(g->alloc, M->nxt);
+    girth_free(g->alloc, M->touched);
+}
+
+static int msbfs_init(const CsrGraph *g, MsbfsWork *M) {
+    size_t n = g->n > 0 ? g->n : 1;
+    M->mask = girth_alloc(g->alloc, n * sizeof(LaneMasks));
+    M->cur = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    M->nxt = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    M->touched = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    if (!M->mask || !M->cur || !M->nxt || !M->touched) {
+        msbfs_free(g, M);
+        return 0;
+    }
+    memset(M->mask, 0, n * sizeof(LaneMasks));
+    return 1;
+}
+
+// Batch of nsrc (<= 64) distinct sources; vertices ranked before minrank are ignored (all the
+// sources are ranked at or after it). Same bound / shared conventions as bfs_cycle_work.
+static int msbfs_batch(const CsrGraph *g, MsbfsWork *M, const uint32_t *src, int nsrc,
+                       const uint32_t *rank, uint32_t minrank, int bound, const int *shared) {
+    LaneMasks *mask = M->mask;
+    const uint64_t *off = g->offsets;
+    const uint32_t *adj = g->adj;
+    uint32_t ncur = 0, nnxt = 0, ntouched = 0;
+
+    for (int i = 0; i < nsrc; i++) {
+        uint32_t v = src[i];
+        mask[v].seen = mask[v].frontier = (uint64_t)1 << i;
+        M->cur[ncur++] = v;
+        M->touched[ntouched++] = v;
+    }
+
+    int best = INF;
+    int limit = bound;
+
+    for (int k = 0; ncur > 0; k++) {
+        if (shared) {
+            int b = __atomic_load_n(shared, __ATOMIC_RELAXED);
+            if (b < limit) limit = b;
+        }
+        if (2 * k + 1 >= limit) break;
+
+        uint64_t odd = 0, even = 0;
+        nnxt = 0;
+        for (uint32_t i = 0; i < ncur; i++) {
+            uint32_t v = M->cur[i];
+            uint64_t fv = mask[v].frontier;
+            for (uint64_t e = off[v]; e < off[v + 1]; e++) {
+                uint32_t w = adj[e];
+                if (rank[w] < minrank) continue;
+                LaneMasks *mw = &mask[w];
+                odd |= fv & mw->frontier;
+                uint64_t fresh = fv & ~mw->seen;
+                if (!fresh) continue;
+                even |= fresh & mw->next;
+                if (!mw->next) M->nxt[nnxt++] = w;
+                mw->next |= fresh;
+            }
+        }
+        if (odd || even) {
+            best = odd ? 2 * k + 1 : 2 * k + 2;
+            break;    // any later level gives at least 2k+3
+        }
+
+        for (uint32_t i = 0; i < ncur; i++) mask[M->cur[i]].frontier = 0;
+        for (uint32_t i = 0; i < nnxt; i++) {
+            LaneMasks *mw = &mask[M->nxt[i]];
+            if (!mw->seen) M->touched[ntouched++] = M->nxt[i];
+            mw->seen |= mw->next;
+            mw->frontier = mw->next;
+            mw->next = 0;
+        }
+        uint32_t *t = M->cur; M->cur = M->nxt; M->nxt = t;
+        ncur = nnxt;
+        nnxt = 0;
+    }
+
+    // Stopped in the middle of a level: its next masks are not in touched yet
+    for (uint32_t i = 0; i < nnxt; i++) mask[M->nxt[i]].next = 0;
+    for (uint32_t i = 0; i < ntouched; i++) {
+        LaneMasks *mv = &mask[M->touched[i]];
+        mv->seen = mv->frontier = mv->next = 0;
+    }
+    return best;
+}
+
+// ============================================================
+//                   SOURCE SCHEDULING
+// ============================================================
+
+// Sources by decreasing degree (counting sort): dense vertices close short cycles early, and
+// removing them first shrinks the graph left to the following searches.
+// Vertices of degree < mindeg (on no cycle: 2 undirected, 1 directed) come last: *nsources
+// counts those before them.
+static uint32_t *degree_order(const CsrGraph *g, uint32_t *rank, uint32_t *nsources,
+                              uint32_t mindeg) {
+    uint32_t n = g->n, maxdeg = 0;
+    *nsources = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        if (csr_degree(g, v) > maxdeg) maxdeg = csr_degree(g, v);
+        if (csr_degree(g, v) >= mindeg) (*nsources)++;
+    }
+    uint32_t *order = girth_alloc(g->alloc, (size_t)(n > 0 ? n : 1) * sizeof(uint32_t));
+    uint32_t *start = girth_alloc(g->alloc, ((size_t)maxdeg + 2) * sizeof(uint32_t));
+    if (!order || !start) {
+        girth_free(g->alloc, order);
+        girth_free(g->alloc, start);
+        return NULL;
+    }
+    memset(start, 0, ((size_t)maxdeg + 2) * sizeof(uint32_t));
+    for (uint32_t v = 0; v < n; v++) start[maxdeg - csr_degree(g, v) + 1]++;
+    for (uint32_t d = 0; d <= maxdeg; d++) start[d + 1] += start[d];
+    for (uint32_t v = 0; v < n; v++) {
+        uint32_t i = start[maxdeg - csr_degree(g, v)]++;
+        order[i] = v;
+        rank[v] = i;
+    }
+    girth_free(g->alloc, start);
+    return order;
+}
+
+// Shared state of a girth search: the source order, the next chunk to hand out and the
+// best length found by any thread (both updated with atomic operations).
+enum { CYCLE_ANY, CYCLE_ODD, CYCLE_DIRECTED };   // kinds of cycle searched
+
+typedef struct {
+    const CsrGraph *g;
+    const uint32_t *order;
+    const uint32_t *rank;
+    uint32_t nsources;    // order[0 .. nsources-1]: vertices that can be on a cycle
+    int lanes;            // 1: one BFS per source, GIRTH_LANES: bit-parallel batches
+    int kind;             // CYCLE_ANY, CYCLE_ODD or CYCLE_DIRECTED (one BFS per source)
+    int minimum;          // shortest possible cycle of that kind: ends the search
+    uint64_t next;
+    int best;
+    int workers;          // threads that obtained their BFS buffers
+    // Witness requested: the source of the best cycle, recorded under lock (rare: only when a
+    // BFS improves on witnessLen), so that its BFS can be replayed once at the end
+    int witness;
+    int witnessLen;
+    uint32_t witnessSource;
+    pthread_mutex_t lock;
+} GirthSearch;
+
+static void atomic_min_int(int *p, int v) {
+    int cur = __atomic_load_n(p, __ATOMIC_RELAXED);
+    while (v < cur && !__atomic_compare_exchange_n(p, &cur, v, 1, __ATOMIC_RELAXED,
+                                                   __ATOMIC_RELAXED))
+        ;
+}
+
+// Next range [*i0, *i1) of the source order, 0 when none is left or the shortest possible
+// cycle is found
+static int next_sources(GirthSearch *S, uint64_t chunk, uint64_t *i0, uint64_t *i1) {
+    if (__atomic_load_n(&S->best, __ATOMIC_RELAXED) <= S->minimum) return 0;
+    *i0 = __atomic_fetch_add(&S->next, chunk, __ATOMIC_RELAXED);
+    if (*i0 >= S->nsources) return 0;
+    *i1 = *i0 + chunk < S->nsources ? *i0 + chunk : S->nsources;
+    return 1;
+}
+
+// Takes GIRTH_CHUNK sources at a time. Early sources (high degree) cost the most, so small
+// chunks keep the threads balanced.
+static void bfs_worker(GirthSearch *S) {
+    const CsrGraph *g = S->g;
+    BfsWork W;
+    if (!work_init(g, &W)) return;
+    __atomic_fetch_add(&S->workers, 1, __ATOMIC_RELAXED);
+    uint64_t i0, i1;
+    while (next_sources(S, GIRTH_CHUNK, &i0, &i1)) {
+        for (uint64_t i = i0; i < i1; i++) {
+            int best = __atomic_load_n(&S->best, __ATOMIC_RELAXED);
+            if (best <= S->minimum) break;
+            int cycle = S->kind == CYCLE_DIRECTED
+                      ? bfs_directed_work(g, &W, S->order[i], S->rank, best, &S->best)
+                      : bfs_cycle_work(g, &W, S->order[i], S->rank, best, &S->best, NULL,
+                                       S->kind == CYCLE_ODD);
+            atomic_min_int(&S->best, cycle);
+            if (S->witness && cycle < INF) {
+                pthread_mutex_lock(&S->lock);
+                if (cycle < S->witnessLen) {
+                    S->witnessLen = cycle;
+                    S->witnessSource = S->order[i];
+                }
+                pthread_mutex_unlock(&S->lock);
+            }
+        }
+    }
+    work_free(g, &W);
+}
+
+// Takes one batch of GIRTH_LANES consecutive sources at a time
+static void msbfs_worker(GirthSearch *S) {
+    const CsrGraph *g = S->g;
+    MsbfsWork M;
+    if (!msbfs_init(g, &M)) return;
+    __atomic_fetch_add(&S->workers, 1, __ATOMIC_RELAXED);
+    uint64_t i0, i1;
+    while (next_sources(S, GIRTH_LANES, &i0, &i1)) {
+        int best = __atomic_load_n(&S->best, __ATOMIC_RELAXED);
+        int cycle = msbfs_batch(g, &M, S->order + i0, (int)(i1 - i0), S->rank, (uint32_t)i0,
+                                best, &S->best);
+        atomic_min_int(&S->best, cycle);
+    }
+    msbfs_free(g, &M);
+}
+
+static void *girth_worker(void *arg) {
+    GirthSearch *S = arg;
+    if (S->lanes > 1) msbfs_worker(S);
+    else bfs_worker(S);
+    return NULL;
+}
+
+// Every shortest cycle C is found by the BFS from its first vertex in the order, which sees
+// all of C; later sources can therefore ignore earlier ones, whatever thread runs them. The
+// global best bounds each BFS, and the shortest possible cycle (a triangle, or a pair of
+// opposite arcs) ends the search.
+// With witness != NULL (one BFS per source only), the BFS of the source that found the girth
+// is run again, with the same rank exclusion, to rebuild the cycle from its parents.
+static int girth_search(const CsrGraph *g, int nthreads, int lanes, int kind,
+                        uint32_t *witness) {
+    if (nthreads < 1) nthreads = 1;
+    uint32_t nsources = 0;
+    uint32_t *rank = girth_alloc(g->alloc, (size_t)(g->n > 0 ? g->n : 1) * sizeof(uint32_t));
+    uint32_t *order = rank ? degree_order(g, rank, &nsources, kind == CYCLE_DIRECTED ? 1 : 2)
+                           : NULL;
+    pthread_t *th = girth_alloc(g->alloc, (size_t)nthreads * sizeof(pthread_t));
+    if (!order || !th) {
+        girth_free(g->alloc, order);
+        girth_free(g->alloc, rank);
+        girth_free(g->alloc, th);
+        return GIRTH_NOMEM;
+    }
+
+    GirthSearch S = { .g = g, .order = order, .rank = rank, .nsources = nsources, .lanes = lanes,
+                      .kind = kind, .minimum = kind == CYCLE_DIRECTED ? 2 : GIRTH_MIN,
+                      .next = 0, .best = INF, .workers = 0,
+                      .witness = witness != NULL, .witnessLen = INF, .witnessSource = 0 };
+    if (S.witness) pthread_mutex_init(&S.lock, NULL);
+    // The calling thread is worker 0; a thread that cannot be started only means less help
+    int started = 1;
+    for (int t = 1; t < nthreads; t++)
+        if (pthread_create(&th[started], NULL, girth_worker, &S) == 0) started++;
+    girth_worker(&S);
+    for (int t = 1; t < started; t++) pthread_join(th[t], NULL);
+
+    int result = S.workers > 0 ? S.best : GIRTH_NOMEM;
+    if (S.witness) {
+        pthread_mutex_destroy(&S.lock);
+        BfsWork W;
+        if (result != GIRTH_NOMEM && result < INF) {
+            if (work_init(g, &W)) {
+                bfs_cycle_work(g, &W, S.witnessSource, rank, S.witnessLen + 1, NULL, witness, 0);
+                work_free(g, &W);
+            } else {
+                result = GIRTH_NOMEM;
+            }
+        }
+    }
+
+    girth_free(g->alloc, th);
+    girth_free(g->alloc, order);
+    girth_free(g->alloc, rank);
+    return result;
+}
+
+int shortestCycleParallel(const CsrGraph *g, int nthreads) {
+    return girth_search(g, nthreads, 1, CYCLE_ANY, NULL);
+}
+
+int shortestCycleBitParallel(const CsrGraph *g, int nthreads) {
+    return girth_search(g, nthreads, GIRTH_LANES, CYCLE_ANY, NULL);
+}
+
+int shortestCycle(const CsrGraph *g) {
+    return girth_search(g, 1, 1, CYCLE_ANY, NULL);
+}
+
+int shortestCycleWitness(const CsrGraph *g, int nthreads, uint32_t *cycle) {
+    return girth_search(g, nthreads, 1, CYCLE_ANY, cycle);
+}
+
+// 2-coloring by BFS over every component, one pass: 1 if no edge joins two vertices of the
+// same color (no odd cycle), 0 otherwise, GIRTH_NOMEM
+static int is_bipartite(const CsrGraph *g) {
+    size_t n = g->n > 0 ? g->n : 1;
+    uint8_t *color = girth_alloc(g->alloc, n);
+    uint32_t *queue = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    if (!color || !queue) {
+        girth_free(g->alloc, color);
+        girth_free(g->alloc, queue);
+        return GIRTH_NOMEM;
+    }
+    memset(color, 0, n);
+    int bipartite = 1;
+    for (uint32_t r = 0; r < g->n && bipartite; r++) {
+        if (color[r]) continue;
+        uint32_t head = 0, tail = 0;
+        color[r] = 1;
+        queue[tail++] = r;
+        while (head < tail && bipartite) {
+            uint32_t v = queue[head++];
+            for (uint64_t k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+                uint32_t w = g->adj[k];
+                if (!color[w]) {
+                    color[w] = 3 - color[v];
+                    queue[tail++] = w;
+                } else if (color[w] == color[v]) {
+                    bipartite = 0;
+                    break;
+                }
+            }
+        }
+    }
+    girth_free(g->alloc, color);
+    girth_free(g->alloc, queue);
+    return bipartite;
+}
+
+// BFS over the bipartite double cover (v, parity of the walk length): a shortest odd closed
+// walk from s reaches (s, odd). The parity of a BFS level is that second coordinate, so the
+// cover is never built: the two copies of a vertex meet on an edge between two vertices of
+// the same level d, closing an odd walk of length 2d+1 that contains an odd cycle at most that
+// long. From a vertex of a shortest odd cycle, the ball holding the cycle cannot be 2-colored
+// by level parity, so some edge inside a level gives exactly its length.
+int shortestOddCycle(const CsrGraph *g, int nthreads) {
+    int bipartite = is_bipartite(g);
+    if (bipartite == GIRTH_NOMEM) return GIRTH_NOMEM;
+    return bipartite ? INF : girth_search(g, nthreads, 1, CYCLE_ODD, NULL);
+}
+
+// Kahn's algorithm, one pass: 1 if peeling the vertices without incoming arcs empties the
+// graph (no directed cycle), 0 otherwise, GIRTH_NOMEM
+static int is_acyclic(const CsrGraph *g) {
+    size_t n = g->n > 0 ? g->n : 1;
+    uint32_t *indeg = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    uint32_t *queue = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    if (!indeg || !queue) {
+        girth_free(g->alloc, indeg);
+        girth_free(g->alloc, queue);
+        return GIRTH_NOMEM;
+    }
+    memset(indeg, 0, n * sizeof(uint32_t));
+    for (uint64_t k = 0; k < g->m; k++) indeg[g->adj[k]]++;
+    uint32_t head = 0, tail = 0;
+    for (uint32_t v = 0; v < g->n; v++)
+        if (indeg[v] == 0) queue[tail++] = v;
+    while (head < tail) {
+        uint32_t v = queue[head++];
+        for (uint64_t k = g->offsets[v]; k < g->offsets[v + 1]; k++)
+            if (--indeg[g->adj[k]] == 0) queue[tail++] = g->adj[k];
+    }
+    girth_free(g->alloc, indeg);
+    girth_free(g->alloc, queue);
+    return tail == g->n;
+}
+
+int shortestDirectedCycle(const CsrGraph *g, int nthreads) {
+    int acyclic = is_acyclic(g);
+    if (acyclic == GIRTH_NOMEM) return GIRTH_NOMEM;
+    return acyclic ? INF : girth_search(g, nthreads, 1, CYCLE_DIRECTED, NULL);
+}
+
+static int has_edge(const CsrGraph *g, uint32_t u, uint32_t v) {
+    return csr_find(g, u, v) < g->offsets[u + 1];
+}
+
+int girth_is_cycle(const CsrGraph *g, const uint32_t *cycle, int len) {
+    if (len < GIRTH_MIN || (uint32_t)len > g->n) return 0;
+    for (int i = 0; i < len; i++)
+        if (cycle[i] >= g->n || !has_edge(g, cycle[i], cycle[(i + 1) % len])) return 0;
+    // Distinct vertices: sorted copy
+    uint32_t *sorted = girth_alloc(g->alloc, (size_t)len * sizeof(uint32_t));
+    if (!sorted) return GIRTH_NOMEM;
+    memcpy(sorted, cycle, (size_t)len * sizeof(uint32_t));
+    qsort(sorted, (size_t)len, sizeof(uint32_t), cmp_u32);
+    int simple = 1;
+    for (int i = 1; i < len && simple; i++) simple = sorted[i] != sorted[i - 1];
+    girth_free(g->alloc, sorted);
+    return simple;
+}
+
+// ============================================================
+//                       LOCAL GIRTH
+// ============================================================
+
+// bridge[k] = 1 when the edge adj[k] is a bridge (on no cycle). Iterative DFS with low links:
+// the tree edge p-v is a bridge when nothing below v reaches above v (low[v] > tin[p]).
+static uint8_t *find_bridges(const CsrGraph *g) {
+    const GirthAllocator *A = g->alloc;
+    uint32_t n = g->n;
+    size_t nn = n > 0 ? n : 1;
+    uint8_t *bridge = girth_alloc(A, (size_t)(g->m > 0 ? g->m : 1));
+    uint32_t *tin = girth_alloc(A, nn * sizeof(uint32_t));
+    uint32_t *low = girth_alloc(A, nn * sizeof(uint32_t));
+    uint32_t *parent = girth_alloc(A, nn * sizeof(uint32_t));
+    uint32_t *stack = girth_alloc(A, nn * sizeof(uint32_t));
+    uint64_t *next = girth_alloc(A, nn * sizeof(uint64_t));
+    if (!bridge || !tin || !low || !parent || !stack || !next) {
+        girth_free(A, bridge);
+        bridge = NULL;
+        goto done;
+    }
+    memset(bridge, 0, (size_t)g->m);
+    for (uint32_t v = 0; v < n; v++) tin[v] = NO_PARENT;
+
+    uint32_t timer = 0;
+    for (uint32_t r = 0; r < n; r++) {
+        if (tin[r] != NO_PARENT) continue;
+        uint32_t top = 0;
+        stack[top++] = r;
+        tin[r] = low[r] = timer++;
+        parent[r] = NO_PARENT;
+        next[r] = g->offsets[r];
+        while (top > 0) {
+            uint32_t v = stack[top - 1];
+            if (next[v] < g->offsets[v + 1]) {
+                uint32_t w = g->adj[next[v]++];
+                if (w == parent[v]) continue;   // simple graph: one edge back to the parent
+                if (tin[w] == NO_PARENT) {
+                    tin[w] = low[w] = timer++;
+                    parent[w] = v;
+                    next[w] = g->offsets[w];
+                    stack[top++] = w;
+                } else if (tin[w] < low[v]) {
+                    low[v] = tin[w];
+                }
+                continue;
+            }
+            top--;
+            uint32_t p = parent[v];
+            if (p == NO_PARENT) continue;
+            if (low[v] < low[p]) low[p] = low[v];
+            if (low[v] > tin[p]) {
+                // p's entry for v is the one just consumed; v's entry for p by binary search
+                bridge[next[p] - 1] = 1;
+                bridge[csr_find(g, v, p)] = 1;
+            }
+        }
+    }
+
+done:
+    girth_free(A, tin);
+    girth_free(A, low);
+    girth_free(A, parent);
+    girth_free(A, stack);
+    girth_free(A, next);
+    return bridge;
+}
+
+// Shortest cycle through s. Every vertex is labeled with its branch, the neighbor of s it
+// descends from (kept in W->parent). A non-tree edge x-y between two branches closes the
+// simple cycle s..x y..s of length distance[x]+distance[y]+1; on a shortest cycle through s
+// the two neighbors of s are in different branches, so one of its edges joins two branches
+// and gives at most its length. Bridges are skipped (no cycle uses them). Same stopping rule
+// as bfs_cycle_work: nothing shorter than 2*distance[v]+1 can close after v.
+static int bfs_local_work(const CsrGraph *g, BfsWork *W, uint32_t s, const uint8_t *bridge) {
+    uint8_t *etat = W->etat;
+    int *distance = W->distance;
+    uint32_t *branch = W->parent;
+    uint32_t *queue = W->queue;
+    const uint64_t *off = g->offsets;
+    const uint32_t *adj = g->adj;
+    uint32_t head = 0, tail = 0;
+
+    etat[s] = VISITE;
+    distance[s] = 0;
+    queue[tail++] = s;
+    int best = INF;
+
+    while (head < tail) {
+        uint32_t v = queue[head++];
+        if (2 * distance[v] + 1 >= best) break;
+        for (uint64_t k = off[v]; k < off[v + 1]; k++) {
+            uint32_t w = adj[k];
+            if (bridge[k] || w == s) continue;
+            if (etat[w] == NON_VISITE) {
+                etat[w] = EN_COURS;
+                distance[w] = distance[v] + 1;
+                branch[w] = v == s ? w : branch[v];
+                queue[tail++] = w;
+            } else if (v != s && branch[w] != branch[v]) {
+                int cycle_length = distance[v] + distance[w] + 1;
+                if (cycle_length < best) best = cycle_length;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < tail; i++) {
+        uint32_t u = queue[i];
+        etat[u] = NON_VISITE;
+        distance[u] = INF;
+        branch[u] = NO_PARENT;
+    }
+    return best;
+}
+
+typedef struct {
+    const CsrGraph *g;
+    const uint8_t *bridge;
+    int *local;
+    uint64_t next;
+    int best;
+    int workers;
+} LocalSearch;
+
+static void *local_worker(void *arg) {
+    LocalSearch *S = arg;
+    const CsrGraph *g = S->g;
+    BfsWork W;
+    if (!work_init(g, &W)) return NULL;
+    __atomic_fetch_add(&S->workers, 1, __ATOMIC_RELAXED);
+    for (;;) {
+        uint64_t i0 = __atomic_fetch_add(&S->next, GIRTH_CHUNK, __ATOMIC_RELAXED);
+        if (i0 >= g->n) break;
+        uint64_t i1 = i0 + GIRTH_CHUNK < g->n ? i0 + GIRTH_CHUNK : g->n;
+        for (uint64_t s = i0; s < i1; s++) {
+            // On a cycle only with two edges that are not bridges
+            int inner = 0;
+            for (uint64_t k = g->offsets[s]; k < g->offsets[s + 1] && inner < 2; k++)
+                inner += !S->bridge[k];
+            S->local[s] = inner < 2 ? INF : bfs_local_work(g, &W, (uint32_t)s, S->bridge);
+            atomic_min_int(&S->best, S->local[s]);
+        }
+    }
+    work_free(g, &W);
+    return NULL;
+}
+
+// Sources are independent (no rank exclusion, every vertex needs its own value), handed out
+// in chunks of GIRTH_CHUNK as in girth_search
+int localGirth(const CsrGraph *g, int nthreads, int *local) {
+    if (nthreads < 1) nthreads = 1;
+    uint8_t *bridge = find_bridges(g);
+    pthread_t *th = girth_alloc(g->alloc, (size_t)nthreads * sizeof(pthread_t));
+    if (!bridge || !th) {
+        girth_free(g->alloc, bridge);
+        girth_free(g->alloc, th);
+        return GIRTH_NOMEM;
+    }
+
+    LocalSearch S = { g, bridge, local, 0, INF, 0 };
+    int started = 1;
+    for (int t = 1; t < nthreads; t++)
+        if (pthread_create(&th[started], NULL, local_worker, &S) == 0) started++;
+    local_worker(&S);
+    for (int t = 1; t < started; t++) pthread_join(th[t], NULL);
+
+    girth_free(g->alloc, th);
+    girth_free(g->alloc, bridge);
+    return S.workers > 0 ? S.best : GIRTH_NOMEM;
+}
+
+int girth_save_local(const char *path, uint32_t n, const int *local, const uint32_t *ids,
+                     int csv) {
+    FILE *out = fopen(path, csv ? "w" : "wb");
+    if (!out) return GIRTH_IO_FILE;
+    int ok;
+    if (csv) {
+        ok = fputs("vertex,local_girth\n", out) >= 0;
+        for (uint32_t v = 0; ok && v < n; v++) {
+            unsigned long id = ids ? ids[v] : v;
+            ok = (local[v] == INF ? fprintf(out, "%lu,\n", id)
+                                  : fprintf(out, "%lu,%d\n", id, local[v])) > 0;
+        }
+    } else {
+        unsigned char buf[4096 * 2 * sizeof(uint32_t)];
+        memcpy(buf, GIRTH_LOCAL_MAGIC, 8);
+        for (int i = 0; i < 8; i++) buf[8 + i] = (unsigned char)((uint64_t)n >> (8 * i));
+        ok = fwrite(buf, 1, 16, out) == 16;
+        size_t k = 0;
+        for (uint32_t v = 0; ok && v < n; v++) {
+            put_le32(buf + k, ids ? ids[v] : v);
+            put_le32(buf + k + 4, local[v] == INF ? 0 : (uint32_t)local[v]);
+            k += 2 * sizeof(uint32_t);
+            if (k == sizeof(buf) || v + 1 == n) {
+                ok = fwrite(buf, 1, k, out) == k;
+                k = 0;
+            }
+        }
+    }
+    if (fclose(out) != 0) ok = 0;
+    return ok ? GIRTH_IO_OK : GIRTH_IO_FILE;
+}
+
+// ============================================================
+//                   MINIMUM-WEIGHT CYCLE
+// ============================================================
+
+// Radix heap: Dijkstra extracts keys in nondecreasing order, so a key is only compared with
+// last, the last key extracted. Bucket 0 holds the keys equal to last, bucket i (1..64) those
+// whose highest bit differing from last is bit i-1. When bucket 0 is empty, the first nonempty
+// bucket is spread over the lower ones around its minimum (the new last): an item moves down
+// at most 64 times, each move O(1). A decrease-key is a second push; the stale copy is skipped
+// when it comes out.
+#define HEAP_BUCKETS 65
+
+typedef struct {
+    uint64_t key;
+    uint32_t v;
+} HeapItem;
+
+typedef struct {
+    HeapItem *item[HEAP_BUCKETS];
+    uint64_t size[HEAP_BUCKETS], cap[HEAP_BUCKETS];
+    uint64_t last;
+    const GirthAllocator *alloc;
+} RadixHeap;
+
+static int heap_bucket(const RadixHeap *H, uint64_t key) {
+    return key == H->last ? 0 : 64 - __builtin_clzll(key ^ H->last);
+}
+
+// key >= H->last; 0 when memory is short
+static int heap_push(RadixHeap *H, uint64_t key, uint32_t v) {
+    int b = heap_bucket(H, key);
+    if (H->size[b] == H->cap[b]) {
+        uint64_t cap = H->cap[b] ? 2 * H->cap[b] : 64;
+        HeapItem *t = girth_alloc(H->alloc, (size_t)cap * sizeof(HeapItem));
+        if (!t) return 0;
+        if (H->size[b]) memcpy(t, H->item[b], (size_t)H->size[b] * sizeof(HeapItem));
+        girth_free(H->alloc, H->item[b]);
+        H->item[b] = t;
+        H->cap[b] = cap;
+    }
+    H->item[b][H->size[b]].key = key;
+    H->item[b][H->size[b]].v = v;
+    H->size[b]++;
+    return 1;
+}
+
+// 1 with a smallest item in *key, *v; 0 when the heap is empty; GIRTH_NOMEM
+static int heap_pop(RadixHeap *H, uint64_t *key, uint32_t *v) {
+    if (H->size[0] == 0) {
+        int i = 1;
+        while (i < HEAP_BUCKETS && H->size[i] == 0) i++;
+        if (i == HEAP_BUCKETS) return 0;
+        const HeapItem *it = H->item[i];
+        uint64_t len = H->size[i], mn = it[0].key;
+        for (uint64_t j = 1; j < len; j++)
+            if (it[j].key < mn) mn = it[j].key;
+        H->last = mn;
+        H->size[i] = 0;
+        // Every item lands in a bucket below i, so it[] stays in place meanwhile
+        for (uint64_t j = 0; j < len; j++)
+            if (!heap_push(H, it[j].key, it[j].v)) return GIRTH_NOMEM;
+    }
+    H->size[0]--;
+    *key = H->item[0][H->size[0]].key;
+    *v = H->item[0][H->size[0]].v;
+    return 1;
+}
+
+// Dijkstra buffers, reset after each search like BfsWork (only the vertices reached)
+typedef struct {
+    uint64_t *dist;       // UINT64_MAX: not reached
+    uint32_t *parent;
+    uint8_t *done;        // distance final
+    uint32_t *touched;    // vertices reached
+    RadixHeap heap;
+    int nomem;            // the heap could not grow: results invalid
+} DijkstraWork;
+
+static void dijkstra_free(const CsrGraph *g, DijkstraWork *D) {
+    girth_free(g->alloc, D->dist);
+    girth_free(g->alloc, D->parent);
+    girth_free(g->alloc, D->done);
+    girth_free(g->alloc, D->touched);
+    for (int b = 0; b < HEAP_BUCKETS; b++) girth_free(g->alloc, D->heap.item[b]);
+}
+
+static int dijkstra_init(const CsrGraph *g, DijkstraWork *D) {
+    size_t n = g->n > 0 ? g->n : 1;
+    memset(D, 0, sizeof(*D));
+    D->heap.alloc = g->alloc;
+    D->dist = girth_alloc(g->alloc, n * sizeof(uint64_t));
+    D->parent = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    D->done = girth_alloc(g->alloc, n * sizeof(uint8_t));
+    D->touched = girth_alloc(g->alloc, n * sizeof(uint32_t));
+    if (!D->dist || !D->parent || !D->done || !D->touched) {
+        dijkstra_free(g, D);
+        return 0;
+    }
+    for (uint32_t i = 0; i < g->n; i++) {
+        D->dist[i] = UINT64_MAX;
+        D->parent[i] = NO_PARENT;
+        D->done[i] = 0;
+    }
+    return 1;
+}
+
+// Lightest cycle closed in the shortest-path tree of s, the weighted bfs_cycle_work. When v
+// is settled, an edge v-w to an already settled w other than v's tree edge (parent[v] != w)
+// closes the walk s..v w..s of weight dist[v]+w(v,w)+dist[w], which contains a cycle at most
+// that heavy. For a lightest cycle C and s on C, some edge of C is outside the tree and the
+// two arcs of C avoiding it bound its walk by w(C), so the minimum over all sources is exact.
+// Keys come out in nondecreasing order and any closure after v weighs at least 2*dist[v]:
+// the search stops there against the best weight known (bound, *shared, or found here).
+// Same rank convention as bfs_cycle_work. Returns the lightest weight found (UINT64_MAX if
+// none); D->nomem is set if the heap could not grow.
+static uint64_t dijkstra_cycle_work(const CsrGraph *g, DijkstraWork *D, uint32_t s,
+                                    const uint32_t *rank, uint64_t bound, const uint64_t *shared) {
+    uint64_t *dist = D->dist;
+    uint32_t *parent = D->parent;
+    uint8_t *done = D->done;
+    const uint64_t *off = g->offsets;
+    const uint32_t *adj = g->adj;
+    const uint32_t *weight = g->weight;
+    uint32_t ntouched = 0;
+    uint32_t rs = rank ? rank[s] : 0;
+
+    for (int b = 0; b < HEAP_BUCKETS; b++) D->heap.size[b] = 0;
+    D->heap.last = 0;
+    dist[s] = 0;
+    D->touched[ntouched++] = s;
+    if (!heap_push(&D->heap, 0, s)) D->nomem = 1;
+
+    uint64_t best = UINT64_MAX;
+    uint64_t limit = bound;
+    uint64_t d;
+    uint32_t v;
+    int r;
+    while (!D->nomem && (r = heap_pop(&D->heap, &d, &v)) != 0) {
+        if (r == GIRTH_NOMEM) { D->nomem = 1; break; }
+        if (done[v] || d != dist[v]) continue;    // stale copy
+        if (shared) {
+            uint64_t b = __atomic_load_n(shared, __ATOMIC_RELAXED);
+            if (b < limit) limit = b;
+        }
+        if (2 * d >= limit) break;
+        done[v] = 1;
+        for (uint64_t k = off[v]; k < off[v + 1]; k++) {
+            uint32_t w = adj[k];
+            if (rank && rank[w] < rs) continue;
+            uint64_t dw = d + (weight ? weight[k] : 1);
+            if (done[w]) {
+                // w settled first, so parent[w] != v: only v's own tree edge is excluded
+                if (parent[v] != w && dw + dist[w] < best) {
+                    best = dw + dist[w];
+                    if (best < limit) limit = best;
+                }
+            } else if (dw < dist[w]) {
+                if (dist[w] == UINT64_MAX) D->touched[ntouched++] = w;
+                dist[w] = dw;
+                parent[w] = v;
+                if (!heap_push(&D->heap, dw, w)) { D->nomem = 1; break; }
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < ntouched; i++) {
+        uint32_t u = D->touched[i];
+        dist[u] = UINT64_MAX;
+        parent[u] = NO_PARENT;
+        done[u] = 0;
+    }
+    return best;
+}
+
+// Shared state of a weighted search, as GirthSearch
+typedef struct {
+    const CsrGraph *g;
+    const uint32_t *order;
+    const uint32_t *rank;
+    uint32_t nsources;
+    uint64_t next;
+    uint64_t best;
+    int workers;
+    int nomem;
+} WeightedSearch;
+
+static void atomic_min_u64(uint64_t *p, uint64_t v) {
+    uint64_t cur = __atomic_load_n(p, __ATOMIC_RELAXED);
+    while (v < cur && !__atomic_compare_exchange_n(p, &cur, v, 1, __ATOMIC_RELAXED,
+                                                   __ATOMIC_RELAXED))
+        ;
+}
+
+static void *weighted_worker(void *arg) {
+    WeightedSearch *S = arg;
+    const CsrGraph *g = S->g;
+    DijkstraWork D;
+    if (!dijkstra_init(g, &D)) return NULL;
+    __atomic_fetch_add(&S->workers, 1, __ATOMIC_RELAXED);
+    while (!D.nomem) {
+        uint64_t i0 = __atomic_fetch_add(&S->next, GIRTH_CHUNK, __ATOMIC_RELAXED);
+        if (i0 >= S->nsources) break;
+        uint64_t i1 = i0 + GIRTH_CHUNK < S->nsources ? i0 + GIRTH_CHUNK : S->nsources;
+        for (uint64_t i = i0; i < i1 && !D.nomem; i++) {
+            uint64_t best = __atomic_load_n(&S->best, __ATOMIC_RELAXED);
+            atomic_min_u64(&S->best, dijkstra_cycle_work(g, &D, S->order[i], S->rank, best,
+                                                         &S->best));
+        }
+    }
+    if (D.nomem) __atomic_store_n(&S->nomem, 1, __ATOMIC_RELAXED);
+    dijkstra_free(g, &D);
+    return NULL;
+}
+
+// Same scheduling as girth_search: sources by decreasing degree in chunks of GIRTH_CHUNK, each
+// Dijkstra ignoring the sources before it and bounded by the global best
+int64_t minimumWeightCycle(const CsrGraph *g, int nthreads) {
+    if (nthreads < 1) nthreads = 1;
+    uint32_t nsources = 0;
+    uint32_t *rank = girth_alloc(g->alloc, (size_t)(g->n > 0 ? g->n : 1) * sizeof(uint32_t));
+    uint32_t *order = rank ? degree_order(g, rank, &nsources, 2) : NULL;
+    pthread_t *th = girth_alloc(g->alloc, (size_t)nthreads * sizeof(pthread_t));
+    if (!order || !th) {
+        girth_free(g->alloc, order);
+        girth_free(g->alloc, rank);
+        girth_free(g->alloc, th);
+        return GIRTH_NOMEM;
+    }
+
+    WeightedSearch S = { g, order, rank, nsources, 0, UINT64_MAX, 0, 0 };
+    int started = 1;
+    for (int t = 1; t < nthreads; t++)
+        if (pthread_create(&th[started], NULL, weighted_worker, &S) == 0) started++;
+    weighted_worker(&S);
+    for (int t = 1; t < started; t++) pthread_join(th[t], NULL);
+
+    girth_free(g->alloc, th);
+    girth_free(g->alloc, order);
+    girth_free(g->alloc, rank);
+    if (S.workers == 0 || S.nomem) return GIRTH_NOMEM;
+    return S.best == UINT64_MAX ? GIRTH_WINF : (int64_t)S.best;
+}
+
+// ============================================================
+//                     INCREMENTAL GIRTH
+// ============================================================
+
+// Rows grow by doubling and stay sorted: presence is a binary search, an insertion or a
+// deletion moves the tail of the row by one slot (a memmove, even on a hub).
+// set[] is a union-find of every edge ever inserted: deletions only split components, so two
+// vertices in different sets are disconnected in the current graph as well.
+typedef struct {
+    uint32_t *adj;
+    uint32_t deg, cap;
+} DynRow;
+
+struct GirthDynamic {
+    const GirthAllocator *alloc;
+    uint32_t n;
+    uint32_t cap;         // vertices the arrays below can hold (grows by doubling)
+    int nthreads;
+    uint64_t nedges;
+    DynRow *row;
+    uint32_t *set;
+    int girth;
+    int stale;            // a deletion broke the witness: girth recomputed when asked
+    uint32_t *cycle;      // witness, cycle[0 .. girth-1] (n entries)
+    uint64_t recomputes;
+    // Bidirectional BFS, side 0 from u and side 1 from v, reset after each search
+    int *dist[2];
+    uint32_t *parent[2];
+    uint32_t *queue[2];
+};
+
+void girth_dynamic_free(GirthDynamic *D) {
+    if (!D) return;
+    const GirthAllocator *A = D->alloc;
+    if (D->row)
+        for (uint32_t v = 0; v < D->n; v++) girth_free(A, D->row[v].adj);
+    girth_free(A, D->row);
+    girth_free(A, D->set);
+    girth_free(A, D->cycle);
+    for (int s = 0; s < 2; s++) {
+        girth_free(A, D->dist[s]);
+        girth_free(A, D->parent[s]);
+        girth_free(A, D->queue[s]);
+    }
+    girth_free(A, D);
+}
+
+GirthDynamic *girth_dynamic_create(const GirthAllocator *A, uint32_t n, int nthreads) {
+    GirthDynamic *D = girth_alloc(A, sizeof(GirthDynamic));
+    if (!D) return NULL;
+    memset(D, 0, sizeof(*D));
+    D->alloc = A;
+    D->nthreads = nthreads < 1 ? 1 : nthreads;
+    D->girth = INF;
+    if (girth_dynamic_reserve(D, n > 0 ? n : 1) != 0) {
+        girth_dynamic_free(D);
+        return NULL;
+    }
+    D->n = n;
+    return D;
+}
+
+// Copy of the first 'keep' bytes of *p into a new block of 'bytes' bytes (*p unchanged)
+static void *grow_block(const GirthAllocator *A, const void *p, size_t keep, size_t bytes) {
+    void *t = girth_alloc(A, bytes);
+    if (t && keep) memcpy(t, p, keep);
+    return t;
+}
+
+int girth_dynamic_reserve(GirthDynamic *D, uint32_t n) {
+    const GirthAllocator *A = D->alloc;
+    if (n > D->cap) {
+        // All blocks are allocated before any is replaced: on failure the graph is unchanged
+        uint32_t cap = D->cap > n / 2 ? (D->cap > UINT32_MAX / 2 ? UINT32_MAX : 2 * D->cap) : n;
+        size_t old = D->n;
+        void *row = grow_block(A, D->row, old * sizeof(DynRow), (size_t)cap * sizeof(DynRow));
+        void *set = grow_block(A, D->set, old * sizeof(uint32_t), (size_t)cap * sizeof(uint32_t));
+        void *cycle = grow_block(A, D->cycle, old * sizeof(uint32_t), (size_t)cap * sizeof(uint32_t));
+        void *dist[2], *parent[2], *queue[2];
+        int ok = row && set && cycle;
+        for (int s = 0; s < 2; s++) {
+            dist[s] = grow_block(A, D->dist[s], old * sizeof(int), (size_t)cap * sizeof(int));
+            parent[s] = grow_block(A, D->parent[s], old * sizeof(uint32_t), (size_t)cap * sizeof(uint32_t));
+            queue[s] = girth_alloc(A, (size_t)cap * sizeof(uint32_t));
+            ok = ok && dist[s] && parent[s] && queue[s];
+        }
+        if (!ok) {
+            girth_free(A, row);
+            girth_free(A, set);
+            girth_free(A, cycle);
+            for (int s = 0; s < 2; s++) {
+                girth_free(A, dist[s]);
+                girth_free(A, parent[s]);
+                girth_free(A, queue[s]);
+            }
+            return GIRTH_NOMEM;
+        }
+        girth_free(A, D->row);
+        girth_free(A, D->set);
+        girth_free(A, D->cycle);
+        D->row = row;
+        D->set = set;
+        D->cycle = cycle;
+        for (int s = 0; s < 2; s++) {
+            girth_free(A, D->dist[s]);
+            girth_free(A, D->parent[s]);
+            girth_free(A, D->queue[s]);
+            D->dist[s] = dist[s];
+            D->parent[s] = parent[s];
+            D->queue[s] = queue[s];
+        }
+        D->cap = cap;
+    }
+    // New vertices: isolated, alone in their set
+    for (uint32_t v = D->n; v < n; v++) {
+        memset(&D->row[v], 0, sizeof(DynRow));
+        D->set[v] = v;
+        for (int s = 0; s < 2; s++) {
+            D->dist[s][v] = INF;
+            D->parent[s][v] = NO_PARENT;
+        }
+    }
+    if (n > D->n) D->n = n;
+    return 0;
+}
+
+uint64_t girth_dynamic_recomputes(const GirthDynamic *D) {
+    return D->recomputes;
+}
+
+static uint32_t set_find(uint32_t *set, uint32_t x) {
+    while (set[x] != x) {
+        set[x] = set[set[x]];   // path halving
+        x = set[x];
+    }
+    return x;
+}
+
+// Index of the first neighbor >= v in the sorted row (r->deg if none)
+static uint32_t row_find(const DynRow *r, uint32_t v) {
+    uint32_t lo = 0, hi = r->deg;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (r->adj[mid] < v) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static int row_has(const DynRow *r, uint32_t v) {
+    uint32_t i = row_find(r, v);
+    return i < r->deg && r->adj[i] == v;
+}
+
+// v put at its place in the row (room reserved by row_reserve)
+static void row_insert(DynRow *r, uint32_t v) {
+    uint32_t i = row_find(r, v);
+    memmove(r->adj + i + 1, r->adj + i, (size_t)(r->deg - i) * sizeof(uint32_t));
+    r->adj[i] = v;
+    r->deg++;
+}
+
+// Entry i removed from the row
+static void row_remove(DynRow *r, uint32_t i) {
+    r->deg--;
+    memmove(r->adj + i, r->adj + i + 1, (size_t)(r->deg - i) * sizeof(uint32_t));
+}
+
+// Room for one more neighbor; 0 when memory is short
+static int row_reserve(const GirthAllocator *A, DynRow *r) {
+    if (r->deg < r->cap) return 1;
+    uint32_t cap = r->cap ? 2 * r->cap : 4;
+    uint32_t *t = girth_alloc(A, (size_t)cap * sizeof(uint32_t));
+    if (!t) return 0;
+    if (r->deg) memcpy(t, r->adj, (size_t)r->deg * sizeof(uint32_t));
+    girth_free(A, r->adj);
+    r->adj = t;
+    r->cap = cap;
+    return 1;
+}
+
+// Distance from u to v when it is at most maxdist (INF otherwise), the path u .. v written to
+// D->cycle. Each step expands one whole level of the side with the smaller frontier. The two
+// sides never label the same vertex (that is a meeting), so after levels l0 and l1 the
+// distance exceeds l0 + l1, and the first meeting, one level further, is a shortest path.
+static int bidir_distance(GirthDynamic *D, uint32_t u, uint32_t v, int maxdist) {
+    uint32_t head[2] = { 0, 0 }, tail[2] = { 0, 0 };
+    int level[2] = { 0, 0 };
+    D->dist[0][u] = 0;
+    D->queue[0][tail[0]++] = u;
+    D->dist[1][v] = 0;
+    D->queue[1][tail[1]++] = v;
+
+    int result = INF;
+    uint32_t a = NO_PARENT, b = NO_PARENT;   // meeting edge a-b, a on the side of u
+    while (level[0] + level[1] < maxdist && result == INF) {
+        int s = tail[0] - head[0] <= tail[1] - head[1] ? 0 : 1;
+        if (head[s] == tail[s]) break;       // that side's component is exhausted
+        int *ds = D->dist[s];
+        const int *dt = D->dist[1 - s];
+        uint32_t end = tail[s];
+        while (head[s] < end && result == INF) {
+            uint32_t x = D->queue[s][head[s]++];
+            const DynRow *r = &D->row[x];
+            for (uint32_t i = 0; i < r->deg; i++) {
+                uint32_t y = r->adj[i];
+                if (dt[y] != INF) {
+                    result = level[s] + 1 + dt[y];
+                    a = s == 0 ? x : y;
+                    b = s == 0 ? y : x;
+                    break;
+                }
+                if (ds[y] == INF) {
+                    ds[y] = level[s] + 1;
+                    D->parent[s][y] = x;
+                    D->queue[s][tail[s]++] = y;
+                }
+            }
+        }
+        level[s]++;
+    }
+
+    if (result != INF) {
+        int k = D->dist[0][a];
+        for (uint32_t x = a; x != NO_PARENT; x = D->parent[0][x]) D->cycle[k--] = x;
+        k = D->dist[0][a] + 1;
+        for (uint32_t x = b; x != NO_PARENT; x = D->parent[1][x]) D->cycle[k++] = x;
+    }
+    for (int s = 0; s < 2; s++)
+        for (uint32_t i = 0; i < tail[s]; i++) {
+            uint32_t x = D->queue[s][i];
+            D->dist[s][x] = INF;
+            D->parent[s][x] = NO_PARENT;
+        }
+    return result;
+}
+
+int girth_dynamic_insert(GirthDynamic *D, uint32_t u, uint32_t v) {
+    if (u >= D->n || v >= D->n) return GIRTH_BADID;
+    if (u == v) return 0;
+    DynRow *ru = &D->row[u], *rv = &D->row[v];
+    if (ru->deg <= rv->deg ? row_has(ru, v) : row_has(rv, u)) return 0;
+    if (!row_reserve(D->alloc, ru) || !row_reserve(D->alloc, rv)) return GIRTH_NOMEM;
+
+    uint32_t cu = set_find(D->set, u), cv = set_find(D->set, v);
+    if (cu != cv) {
+        D->set[cu] = cv;           // no path yet: no new cycle
+    } else if (!D->stale && D->girth > GIRTH_MIN) {
+        // The new edge closes cycles of length dist(u,v) + 1: only a path shorter than
+        // girth - 1 matters
+        int dist = bidir_distance(D, u, v, D->girth == INF ? INF - 1 : D->girth - 2);
+        if (dist != INF) D->girth = dist + 1;
+    }
+    row_insert(ru, v);
+    row_insert(rv, u);
+    D->nedges++;
+    return 1;
+}
+
+int girth_dynamic_delete(GirthDynamic *D, uint32_t u, uint32_t v) {
+    if (u >= D->n || v >= D->n) return GIRTH_BADID;
+    DynRow *ru = &D->row[u], *rv = &D->row[v];
+    if (u == v || !row_has(ru, v)) return 0;
+    row_remove(ru, row_find(ru, v));
+    row_remove(rv, row_find(rv, u));
+    D->nedges--;
+
+    // Every other cycle survives: only the loss of the witness can raise the girth
+    if (!D->stale && D->girth != INF)
+        for (int i = 0; i < D->girth; i++) {
+            uint32_t a = D->cycle[i], b = D->cycle[(i + 1) % D->girth];
+            if ((a == u && b == v) || (a == v && b == u)) {
+                D->stale = 1;
+                break;
+            }
+        }
+    return 1;
+}
+
+// From scratch: CSR of the current edges, shortestCycleWitness. The union-find is rebuilt on
+// the way, dropping the connections that deletions have cut.
+static int dynamic_recompute(GirthDynamic *D) {
+    const GirthAllocator *A = D->alloc;
+    Edge *edges = girth_alloc(A, (size_t)(D->nedges > 0 ? D->nedges : 1) * sizeof(Edge));
+    if (!edges) return GIRTH_NOMEM;
+    size_t k = 0;
+    for (uint32_t v = 0; v < D->n; v++) D->set[v] = v;
+    for (uint32_t v = 0; v < D->n; v++)
+        for (uint32_t i = 0; i < D->row[v].deg; i++) {
+            uint32_t w = D->row[v].adj[i];
+            if (w < v) continue;
+            edges[k].u = v;
+            edges[k].v = w;
+            k++;
+            uint32_t cv = set_find(D->set, v), cw = set_find(D->set, w);
+            if (cv != cw) D->set[cv] = cw;
+        }
+    CsrGraph *g = csr_from_edges_parallel(A, D->n, edges, k, D->nthreads);
+    girth_free(A, edges);
+    int girth = g ? shortestCycleWitness(g, D->nthreads, D->cycle) : GIRTH_NOMEM;
+    csr_free(g);
+    if (girth == GIRTH_NOMEM) return GIRTH_NOMEM;
+    D->girth = girth;
+    D->stale = 0;
+    D->recomputes++;
+    return girth;
+}
+
+int girth_dynamic_girth(GirthDynamic *D) {
+    return D->stale ? dynamic_recompute(D) : D->girth;
+}
@@ -0,0 +1,224 @@
+// girth.h
+// Shortest cycle (girth) library: undirected graphs in compressed sparse row form, BFS from
+// every vertex.
+// Build: make (libgirth.a, libgirth.so and the girth_cli program)
+//
+// Re-entrant: no mutable global state, all memory comes from the caller's GirthAllocator
+// (NULL: malloc/free), which a graph keeps for its own arrays and for the BFS work buffers.
+
+#ifndef GIRTH_H
+#define GIRTH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GIRTH_API_VERSION 2   // bumped on every incompatible change to this file
+                              // (2: CsrGraph.weight added)
+
+#if defined(_WIN32) && defined(GIRTH_SHARED)
+#ifdef GIRTH_BUILD
+#define GIRTH_API __declspec(dllexport)
+#else
+#define GIRTH_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define GIRTH_API __attribute__((visibility("default")))
+#else
+#define GIRTH_API
+#endif
+
+#define INF 1000000000        // "no cycle"
+#define GIRTH_NOMEM (-1)      // allocation failure
+#define GIRTH_MIN 3           // shortest possible cycle in a simple graph
+#define GIRTH_WINF INT64_MAX  // "no cycle" for minimumWeightCycle
+
+// alloc: block of bytes bytes aligned on align (power of 2), NULL on failure.
+// release: frees a block returned by alloc (NULL accepted). user is passed through.
+typedef struct {
+    void *(*alloc)(void *user, size_t bytes, size_t align);
+    void (*release)(void *user, void *p);
+    void *user;
+} GirthAllocator;
+
+GIRTH_API void *girth_alloc(const GirthAllocator *A, size_t bytes);
+GIRTH_API void girth_free(const GirthAllocator *A, void *p);
+
+// ============================================================
+//              COMPRESSED SPARSE ROW GRAPH
+// ============================================================
+
+typedef struct {
+    uint32_t u, v;
+} Edge;
+
+// Neighbors of v: adj[offsets[v] .. offsets[v+1]-1], sorted, without duplicates.
+// Every undirected edge appears in both rows, so m = 2 * (number of edges).
+typedef struct {
+    uint32_t n;
+    uint64_t m;
+    uint64_t *offsets;    // n + 1 entries
+    uint32_t *adj;        // m entries
+    const GirthAllocator *alloc;
+    uint32_t *weight;     // m entries, weight[k] for the edge adj[k]; NULL: every edge weighs 1
+} CsrGraph;
+
+// Two passes over the edge list (degrees, then placement); self-loops and repeated edges
+// are dropped, so the graph is simple. NULL if an id is >= n or memory is short.
+GIRTH_API CsrGraph *csr_from_edges(const GirthAllocator *A, uint32_t n, const Edge *edges,
+                                   size_t nedges);
+// Same graph built by nthreads threads (the caller included): degrees and placement over one
+// slice of the edge list per thread, then rows sorted in parallel. No allocation per edge.
+GIRTH_API CsrGraph *csr_from_edges_parallel(const GirthAllocator *A, uint32_t n,
+                                            const Edge *edges, size_t nedges, int nthreads);
+// Same graph with weights[e] the weight of edges[e] (both rows of an edge carry it); an edge
+// given several times keeps its smallest weight
+GIRTH_API CsrGraph *csr_from_edges_weighted(const GirthAllocator *A, uint32_t n,
+                                            const Edge *edges, const uint32_t *weights,
+                                            size_t nedges, int nthreads);
+// Directed graph: edge u v is the arc u -> v, stored in row u only (m = number of arcs, rows
+// sorted); self-loops and repeated arcs are dropped. For shortestDirectedCycle.
+GIRTH_API CsrGraph *csr_from_arcs(const GirthAllocator *A, uint32_t n, const Edge *edges,
+                                  size_t nedges, int nthreads);
+GIRTH_API void csr_free(CsrGraph *g);
+
+static inline uint32_t csr_degree(const CsrGraph *g, uint32_t v) {
+    return (uint32_t)(g->offsets[v + 1] - g->offsets[v]);
+}
+
+// ============================================================
+//                       EDGE-LIST FILES
+// ============================================================
+
+// Text: one edge "u v" per line (spaces, tabs or a comma between the ids, anything after the
+// second id ignored, e.g. a weight); empty lines and lines starting with '#' or '%' skipped.
+// Binary: the 8 bytes "GIRTHE32", the number of edges (uint64), then the edges as pairs of
+// uint32; all little-endian. Ids are unsigned 32-bit integers in both formats.
+#define GIRTH_BINARY_MAGIC "GIRTHE32"
+
+enum { GIRTH_IO_OK = 0, GIRTH_IO_FILE, GIRTH_IO_FORMAT, GIRTH_IO_NOMEM };
+
+typedef struct {
+    int status;           // GIRTH_IO_OK, GIRTH_IO_FILE (open / map / write failure),
+                          // GIRTH_IO_FORMAT or GIRTH_IO_NOMEM
+    uint64_t line;        // GIRTH_IO_FORMAT in a text file: first bad line (from 1)
+    uint64_t bytes;       // file size
+    uint64_t records;     // edges read, loops and repeats included
+    uint32_t maxId;       // largest id in the file
+} GirthLoadInfo;
+
+// Maps the file in memory and parses it with nthreads threads straight into an edge array
+// (none for a binary file: its edges are used in place), then builds the graph with
+// csr_from_edges_parallel. The ids are renumbered 0..n-1 in increasing order; with ids !=
+// NULL, *ids receives the original id of each vertex (n entries, free with girth_free).
+// Renumbering uses a bitmap of the ids (2 bits per id up to maxId), or a sorted copy of the
+// endpoints when the ids are much sparser than the edges. The format is told by the first
+// bytes. NULL on failure; info (may be NULL) gives the reason.
+GIRTH_API CsrGraph *csr_load(const GirthAllocator *A, const char *path, int nthreads,
+                             uint32_t **ids, GirthLoadInfo *info);
+// Same for a weighted text file, one edge "u v w" per line (w: unsigned 32-bit weight, third
+// column required), built with csr_from_edges_weighted. A binary file gives GIRTH_IO_FORMAT.
+GIRTH_API CsrGraph *csr_load_weighted(const GirthAllocator *A, const char *path, int nthreads,
+                                      uint32_t **ids, GirthLoadInfo *info);
+// Same file read as arcs u -> v, built with csr_from_arcs
+GIRTH_API CsrGraph *csr_load_directed(const GirthAllocator *A, const char *path, int nthreads,
+                                      uint32_t **ids, GirthLoadInfo *info);
+// Writes an undirected graph in the binary format, each edge once (ids[v] for vertex v when ids is not
+// NULL), without its weights. GIRTH_IO_OK or GIRTH_IO_FILE.
+GIRTH_API int csr_save_binary(const CsrGraph *g, const char *path, const uint32_t *ids);
+
+// ============================================================
+//                      SHORTEST CYCLE
+// ============================================================
+
+// Shortest cycle closed in the BFS tree of s (INF if none, GIRTH_NOMEM)
+GIRTH_API int BFS_cycle(const CsrGraph *g, uint32_t s);
+// Girth: same result as the minimum of BFS_cycle over all sources, with bounded searches
+// (INF for a forest, GIRTH_NOMEM)
+GIRTH_API int shortestCycle(const CsrGraph *g);
+// Same result with nthreads threads (the caller included) sharing the sources and the best
+// bound; the graph allocator must then accept concurrent calls
+GIRTH_API int shortestCycleParallel(const CsrGraph *g, int nthreads);
+// Same result with 64 sources per BFS (one bit per source in a uint64_t per vertex), each
+// batch reading the adjacency once per level for all its sources
+GIRTH_API int shortestCycleBitParallel(const CsrGraph *g, int nthreads);
+// Same result as shortestCycleParallel, plus one shortest cycle when cycle != NULL: cycle[0 ..
+// girth-1], each vertex adjacent to the next and the last to the first. cycle needs room for
+// g->n vertices. It is rebuilt from the BFS parents at the closing edge, once, after the search
+// (with cycle == NULL nothing is recorded).
+GIRTH_API int shortestCycleWitness(const CsrGraph *g, int nthreads, uint32_t *cycle);
+// Shortest cycle of odd length (INF if g is bipartite, GIRTH_NOMEM): a linear 2-coloring
+// answers bipartite graphs, otherwise one BFS per source over the bipartite double cover,
+// scheduled as shortestCycleParallel
+GIRTH_API int shortestOddCycle(const CsrGraph *g, int nthreads);
+// Shortest directed cycle of a graph from csr_from_arcs (INF if it has none, GIRTH_NOMEM): a
+// linear topological peeling answers acyclic graphs, otherwise one BFS per source until an
+// arc leads back to it, scheduled as shortestCycleParallel. On an undirected graph every edge
+// is two opposite arcs, hence 2 as soon as there is an edge.
+GIRTH_API int shortestDirectedCycle(const CsrGraph *g, int nthreads);
+// 1 if cycle[0 .. len-1] is a simple cycle of g (distinct vertices, consecutive ones adjacent,
+// len >= 3), 0 otherwise, GIRTH_NOMEM
+GIRTH_API int girth_is_cycle(const CsrGraph *g, const uint32_t *cycle, int len);
+
+// ============================================================
+//                       LOCAL GIRTH
+// ============================================================
+
+// local[v] = length of the shortest cycle through v (INF if v is on no cycle), for every
+// vertex, with nthreads threads. Returns the girth (the smallest local[v]) or GIRTH_NOMEM.
+GIRTH_API int localGirth(const CsrGraph *g, int nthreads, int *local);
+// Writes local[] as CSV ("vertex,local_girth", no value for INF) or in binary: the 8 bytes
+// "GIRTHL32", n (uint64), then one pair of uint32 (vertex, length, 0 for INF) per vertex, all
+// little-endian. Vertex v is written as ids[v] when ids is not NULL. GIRTH_IO_OK or
+// GIRTH_IO_FILE.
+#define GIRTH_LOCAL_MAGIC "GIRTHL32"
+GIRTH_API int girth_save_local(const char *path, uint32_t n, const int *local,
+                               const uint32_t *ids, int csv);
+
+// ============================================================
+//                   MINIMUM-WEIGHT CYCLE
+// ============================================================
+
+// Smallest total weight of a cycle (g->weight, 1 per edge when NULL: the girth), with one
+// Dijkstra per source and nthreads threads sharing the sources and the best weight as in
+// shortestCycleParallel. GIRTH_WINF if g is a forest, GIRTH_NOMEM. Weights of zero are
+// accepted; cycle weights are assumed to stay below 2^62 (always true below 2^30 vertices).
+GIRTH_API int64_t minimumWeightCycle(const CsrGraph *g, int nthreads);
+
+// ============================================================
+//                     INCREMENTAL GIRTH
+// ============================================================
+
+#define GIRTH_BADID (-2)      // vertex id >= n
+
+// Graph on vertices 0..n-1 changed one edge at a time, with its girth kept up to date
+// (n can grow with girth_dynamic_reserve).
+// Insertion of u v: the new girth is min(girth, dist(u,v) + 1), dist found by a bidirectional
+// BFS bounded by girth - 2 (none once the girth is 3, none when u and v were never connected).
+// Deletion: the girth changes only if the edge is on the cycle kept as witness; it is then
+// recomputed (shortestCycleWitness with nthreads threads) at the next girth_dynamic_girth,
+// so several deletions in a row cost one recomputation.
+typedef struct GirthDynamic GirthDynamic;
+
+// Empty graph, NULL if memory is short
+GIRTH_API GirthDynamic *girth_dynamic_create(const GirthAllocator *A, uint32_t n, int nthreads);
+GIRTH_API void girth_dynamic_free(GirthDynamic *D);
+// At least n vertices (the new ones isolated), storage grown by doubling: 0, GIRTH_NOMEM
+GIRTH_API int girth_dynamic_reserve(GirthDynamic *D, uint32_t n);
+// 1 if the edge was added / removed, 0 if it was already there / absent (or u == v),
+// GIRTH_BADID, GIRTH_NOMEM (the graph is then unchanged)
+GIRTH_API int girth_dynamic_insert(GirthDynamic *D, uint32_t u, uint32_t v);
+GIRTH_API int girth_dynamic_delete(GirthDynamic *D, uint32_t u, uint32_t v);
+// Current girth (INF for a forest, GIRTH_NOMEM)
+GIRTH_API int girth_dynamic_girth(GirthDynamic *D);
+// Number of full recomputations so far
+GIRTH_API uint64_t girth_dynamic_recomputes(const GirthDynamic *D);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -3,83 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "conio2.h"
-
-#define INF 1000000000
-#define NON_VISITE 0
-#define EN_COURS 1
-#define VISITE 2
-
-// ============================================================
-//              STRUCTURES & GRAPH LOGIC
-// ============================================================
-
-typedef struct Node {
-    int val;
-    struct Node* next;
-} Node;
-
-void addEdge(Node* graph[], int u, int v) {
-    Node* n1 = malloc(sizeof(Node));
-    n1->val = v;
-    n1->next = graph[u];
-    graph[u] = n1;
-
-    Node* n2 = malloc(sizeof(Node));
-    n2->val = u;
-    n2->next = graph[v];
-    graph[v] = n2;
-}
-
-int BFS_cycle(Node* graph[], int n, int s) {
-    int etat[n];
-    int distance[n];
-    int parent[n];
-    int queue[n];
-    int head = 0, tail = 0;
-
-    for (int i = 0; i < n; i++) {
-        etat[i] = NON_VISITE;
-        distance[i] = INF;
-        parent[i] = -1;
-    }
-
-    etat[s] = EN_COURS;
-    distance[s] = 0;
-    queue[tail++] = s;
-
-    int best = INF;
-
-    while (head < tail) {
-        int v = queue[head++];
-        for (Node* cur = graph[v]; cur != NULL; cur = cur->next) {
-            int w = cur->val;
-
-            if (etat[w] == NON_VISITE) {
-                etat[w] = EN_COURS;
-                distance[w] = distance[v] + 1;
-                parent[w] = v;
-                queue[tail++] = w;
-            }
-            else if (etat[w] == EN_COURS && parent[v] != w) {
-                int cycle_length = distance[v] + distance[w] + 1;
-                if (cycle_length < best)
-                    best = cycle_length;
-            }
-        }
-        etat[v] = VISITE;
-    }
-    return best;
-}
-
-int shortestCycle(Node* graph[], int n) {
-    int best = INF;
-    for (int i = 0; i < n; i++) {
-        int cycle = BFS_cycle(graph, n, i);
-        if (cycle < best)
-            best = cycle;
-    }
-    return best;
-}
+#include "girth.h"
 
 // ============================================================
 //                    ENHANCED GUI FUNCTIONS
@@ -170,7 +94,7 @@ void drawMainInterface() {
     }
 }
 
-void displayGraphSection(Node* graph[], int n) {
+void displayGraphSection(const CsrGraph* graph) {
     drawShadowBox(3, 6, 35, 12, WHITE, BLUE);
     
     gotoxy(12, 7);
@@ -180,21 +104,21 @@ void displayGraphSection(Node* graph[], int n) {
     
     textcolor(LIGHTCYAN);
     int y = 9;
-    for (int i = 0; i < n && i < 8; i++) {
+    for (uint32_t i = 0; i < graph->n && i < 8; i++) {
         gotoxy(5, y + i);
         textbackground(BLUE);
-        cprintf("Sommet [%d] -> ", i);
+        cprintf("Sommet [%u] -> ", i);
         
         textcolor(WHITE);
-        Node* curr = graph[i];
+        uint64_t k = graph->offsets[i], end = graph->offsets[i + 1];
         int count = 0;
-        while(curr != NULL && count < 5) {
-            cprintf("%d", curr->val);
-            curr = curr->next;
-            if(curr) cprintf(", ");
+        while(k < end && count < 5) {
+            cprintf("%u", graph->adj[k]);
+            k++;
+            if(k < end) cprintf(", ");
             count++;
         }
-        if(curr != NULL) cprintf("...");
+        if(k < end) cprintf("...");
     }
 }
 
@@ -337,18 +261,6 @@ void displayResult(int result) {
     }
 }
 
-int countEdges(Node* graph[], int n) {
-    int count = 0;
-    for(int i = 0; i < n; i++) {
-        Node* curr = graph[i];
-        while(curr != NULL) {
-            if(curr->val > i) count++; // Count each edge once
-            curr = curr->next;
-        }
-    }
-    return count;
-}
-
 void displayProgressBar(int current, int total) {
     int barWidth = 40;
     int x = 20;
@@ -374,23 +286,32 @@ void displayProgressBar(int current, int total) {
 //                         MAIN
 // ============================================================
 
-int main() {
-    // Initialize Graph
-    int n = 6;
-    Node* graph[n];
-    for (int i = 0; i < n; i++) graph[i] = NULL;
-
-    // Create graph structure (hexagon with diagonals)
-    addEdge(graph, 0, 1);
-    addEdge(graph, 1, 2);
-    addEdge(graph, 2, 3);
-    addEdge(graph, 3, 4);
-    addEdge(graph, 4, 5);
-    addEdge(graph, 5, 0);
-    addEdge(graph, 1, 4);
-    addEdge(graph, 2, 4);
+int main(int argc, char** argv) {
+    // Create graph structure (hexagon with diagonals), or read it from an edge-list file
+    Edge edgeList[] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 0},
+        {1, 4}, {2, 4}
+    };
+    CsrGraph* graph;
+    if (argc > 1) {
+        GirthLoadInfo info;
+        graph = csr_load(NULL, argv[1], 1, NULL, &info);
+        if (graph == NULL) {
+            if (info.status == GIRTH_IO_FORMAT) printf("ERREUR: %s: format invalide\n", argv[1]);
+            else if (info.status == GIRTH_IO_FILE) printf("ERREUR: impossible de lire %s\n", argv[1]);
+            else printf("ERREUR: memoire insuffisante\n");
+            return 1;
+        }
+    } else {
+        graph = csr_from_edges(NULL, 6, edgeList, sizeof(edgeList) / sizeof(edgeList[0]));
+        if (graph == NULL) {
+            printf("ERREUR: memoire insuffisante\n");
+            return 1;
+        }
+    }
 
-    int edges = countEdges(graph, n);
+    int n = (int)graph->n;
+    int edges = (int)(graph->m / 2);
 
     // Draw main interface
     drawMainInterface();
@@ -398,7 +319,7 @@ int main() {
     delay(500);
     
     // Display all sections
-    displayGraphSection(graph, n);
+    displayGraphSection(graph);
     delay(300);
     
     displayComplexitySection();
@@ -420,15 +341,16 @@ int main() {
     animateProcessing();
     
     // Simulate progress
-    for(int i = 0; i <= n; i++) {
-        displayProgressBar(i, n);
+    int steps = n < 1 ? 1 : (n < 20 ? n : 20);
+    for(int i = 0; i <= steps; i++) {
+        displayProgressBar(i, steps);
         delay(200);
     }
     
     delay(500);
     
     // Calculate result
-    int result = shortestCycle(graph, n);
+    int result = shortestCycle(graph);
     
     // Display result
     displayResult(result);
@@ -446,14 +368,7 @@ int main() {
     clrscr();
     
     // Free memory
-    for(int i = 0; i < n; i++) {
-        Node* curr = graph[i];
-        while(curr != NULL) {
-            Node* temp = curr;
-            curr = curr->next;
-            free(temp);
-        }
-    }
+    csr_free(graph);
 
     return 0;
 }
\ No newline at end of file
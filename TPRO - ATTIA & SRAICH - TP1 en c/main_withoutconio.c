@@ -0,0 +1,766 @@
+// Plus court cycle (maille) - version console sans conio
+//   girth_cli                       graphe exemple (hexagone avec deux cordes)
+//   girth_cli --bench V E [s]       graphe aleatoire de V sommets et E aretes (graine s)
+//   girth_cli --bench-ring V C [s]  cycle de V sommets et C cordes aleatoires
+//   girth_cli --bench-pg q          graphe d'incidence du plan projectif sur Z/qZ (q premier):
+//                                   maille 6, diametre 3, chaque BFS va jusqu'au bout
+//   girth_cli --load fichier        graphe lu dans un fichier de liste d'aretes (texte "u v"
+//                                   ou binaire, voir girth.h), maille et un plus court cycle
+//   girth_cli --weighted fichier    cycle de poids minimal d'un graphe pondere (texte "u v w")
+//   girth_cli --directed fichier    plus court cycle oriente (chaque ligne "u v" est l'arc u -> v)
+//   girth_cli --odd fichier         plus court cycle de longueur impaire
+//   girth_cli --bench-road L H [s]  reseau routier synthetique: grille L x H, 15% des rues
+//                                   retirees, longueurs aleatoires de 1 a 1000 (graine s)
+//   girth_cli --dynamic fichier     flot de mises a jour "+ u v" (ajout) / "- u v" (retrait),
+//                                   maille affichee apres chacune, des sa lecture (bilan sur
+//                                   stderr); accepte /dev/stdin ou un tube
+//   girth_cli --convert texte bin   reecrit une liste d'aretes au format binaire
+//   girth_cli --local fichier [s]   maille locale de chaque sommet (plus court cycle qui le
+//                                   contient), ecrite dans s (CSV si s finit par .csv, binaire
+//                                   sinon)
+//   girth_cli --check N [s]         N graphes aleatoires (graine s): chaque moteur compare a une
+//                                   force brute (detour par chaque arete, BFS de retour)
+// Les bancs d'essai mesurent la BFS par source (shortestCycleParallel) et la BFS a 64 sources
+// (shortestCycleBitParallel) avec 1, 2, 4, ... threads jusqu'au nombre de coeurs (ou jusqu'a T
+// avec --threads T); --bench-road mesure Dijkstra par source (minimumWeightCycle).
+
+#define _POSIX_C_SOURCE 200809L   // clock_gettime, sysconf
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "girth.h"
+
+#define BENCH_REPEAT 3            // mesures par nombre de threads (la meilleure est gardee)
+
+// ============================================================
+//                        UTILITIES
+// ============================================================
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned xorshift32(unsigned *s) {
+    unsigned x = *s;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *s = x;
+}
+
+static void printResult(int result) {
+    if (result == GIRTH_NOMEM) printf("ERREUR: memoire insuffisante\n");
+    else if (result == INF) printf("Aucun cycle trouve dans le graphe!\n");
+    else printf("Plus court cycle: %d aretes\n", result);
+}
+
+// Sommets d'un plus court cycle (les 16 premiers si plus long), identifiants d'origine si ids
+static void printCycle(const CsrGraph *graph, const uint32_t *cycle, int len, const uint32_t *ids) {
+    printf("Cycle:");
+    for (int i = 0; i < len && i < 16; i++) printf(" %u", ids ? ids[cycle[i]] : cycle[i]);
+    if (len > 16) printf(" ... (%d sommets)", len);
+    printf(" -> %s\n", girth_is_cycle(graph, cycle, len) == 1 ? "cycle simple verifie" : "ERREUR: cycle invalide");
+}
+
+static void printWeight(int64_t result) {
+    if (result == GIRTH_NOMEM) printf("ERREUR: memoire insuffisante\n");
+    else if (result == GIRTH_WINF) printf("Aucun cycle trouve dans le graphe!\n");
+    else printf("Cycle de poids minimal: %lld\n", (long long)result);
+}
+
+static double csrMegabytes(const CsrGraph *g) {
+    return ((g->n + 1.0) * sizeof(uint64_t) + g->m * (g->weight ? 2.0 : 1.0) * sizeof(uint32_t)) / 1e6;
+}
+
+// ============================================================
+//                          MODES
+// ============================================================
+
+static int runExample(void) {
+    // Hexagon with diagonals
+    Edge edgeList[] = {
+        {0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}, {5, 0},
+        {1, 4}, {2, 4}
+    };
+    CsrGraph *graph = csr_from_edges(NULL, 6, edgeList, sizeof(edgeList) / sizeof(edgeList[0]));
+    if (!graph) { printResult(GIRTH_NOMEM); return 1; }
+
+    printf("Sommets: %u  |  Aretes: %llu\n", graph->n, (unsigned long long)(graph->m / 2));
+    for (uint32_t v = 0; v < graph->n; v++) {
+        printf("Sommet [%u] ->", v);
+        for (uint64_t k = graph->offsets[v]; k < graph->offsets[v + 1]; k++)
+            printf(" %u", graph->adj[k]);
+        printf("\n");
+    }
+    uint32_t cycle[6];
+    int result = shortestCycleWitness(graph, 1, cycle);
+    printResult(result);
+    if (result != GIRTH_NOMEM && result != INF) printCycle(graph, cycle, result, NULL);
+
+    int local[6];
+    if (localGirth(graph, 1, local) != GIRTH_NOMEM) {
+        printf("Maille locale:");
+        for (uint32_t v = 0; v < graph->n; v++) printf(" [%u] %d", v, local[v]);
+        printf("\n");
+    }
+    csr_free(graph);
+    return result == GIRTH_NOMEM;
+}
+
+static int cpuCount(void) {
+    long c = sysconf(_SC_NPROCESSORS_ONLN);
+    return c > 0 ? (int)c : 1;
+}
+
+typedef int (*GirthEngine)(const CsrGraph *g, int nthreads);
+
+// Temps de chaque moteur pour 1, 2, 4, ... threads, puis maxThreads. L'acceleration est
+// relative a la BFS par source sur un thread.
+static int benchThreads(const CsrGraph *graph, int maxThreads) {
+    static const struct { const char *name; GirthEngine run; } engines[] = {
+        { "BFS/source", shortestCycleParallel },
+        { "BFS x64", shortestCycleBitParallel }
+    };
+    printf("%-12s %-8s %-12s %-10s %s\n", "Moteur", "Threads", "Temps(s)", "Speedup", "Maille");
+    double t1 = 0;
+    for (int m = 0; m < 2; m++) {
+        for (int t = 1; t <= maxThreads; t = (t < maxThreads && 2 * t > maxThreads) ? maxThreads : 2 * t) {
+            double best = 1e30;
+            int result = INF;
+            for (int r = 0; r < BENCH_REPEAT; r++) {
+                double t0 = wall_seconds();
+                result = engines[m].run(graph, t);
+                double dt = wall_seconds() - t0;
+                if (dt < best) best = dt;
+            }
+            if (result == GIRTH_NOMEM) { printResult(result); return 1; }
+            if (m == 0 && t == 1) t1 = best;
+            printf("%-12s %-8d %-12.4f %-10.2f %d\n", engines[m].name, t, best,
+                   best > 0 ? t1 / best : 0.0, result);
+        }
+    }
+    return 0;
+}
+
+// Meme principe pour minimumWeightCycle; la maille (BFS) du meme graphe sert de reference
+static int benchWeighted(const CsrGraph *graph, int maxThreads) {
+    double t0 = wall_seconds();
+    int girth = shortestCycleParallel(graph, maxThreads);
+    double tBfs = wall_seconds() - t0;
+    printf("Maille (BFS/source, %d threads, sans les poids): %d aretes, %.4f s\n", maxThreads,
+           girth, tBfs);
+    printf("%-12s %-8s %-12s %-10s %s\n", "Moteur", "Threads", "Temps(s)", "Speedup", "Poids");
+    double t1 = 0;
+    for (int t = 1; t <= maxThreads; t = (t < maxThreads && 2 * t > maxThreads) ? maxThreads : 2 * t) {
+        double best = 1e30;
+        int64_t result = GIRTH_WINF;
+        for (int r = 0; r < BENCH_REPEAT; r++) {
+            t0 = wall_seconds();
+            result = minimumWeightCycle(graph, t);
+            double dt = wall_seconds() - t0;
+            if (dt < best) best = dt;
+        }
+        if (result == GIRTH_NOMEM) { printWeight(result); return 1; }
+        if (t == 1) t1 = best;
+        printf("%-12s %-8d %-12.4f %-10.2f %lld\n", "Dijkstra", t, best, best > 0 ? t1 / best : 0.0,
+               (long long)result);
+    }
+    return 0;
+}
+
+static int runBench(uint32_t n, size_t nedges, unsigned seed, int ring, int maxThreads) {
+    if (n < 2) { printf("ERREUR: au moins 2 sommets\n"); return 1; }
+    size_t total = nedges + (ring ? n : 0);
+    Edge *edges = malloc((total ? total : 1) * sizeof(Edge));
+    if (!edges) { printResult(GIRTH_NOMEM); return 1; }
+    unsigned rng = seed ? seed : 1;
+    size_t m = 0;
+    if (ring) {
+        for (uint32_t v = 0; v < n; v++) {
+            edges[m].u = v;
+            edges[m].v = (v + 1) % n;
+            m++;
+        }
+    }
+    for (size_t e = 0; e < nedges; e++, m++) {
+        edges[m].u = xorshift32(&rng) % n;
+        edges[m].v = xorshift32(&rng) % n;
+    }
+
+    double t0 = wall_seconds();
+    CsrGraph *graph = csr_from_edges(NULL, n, edges, m);
+    double tBuild = wall_seconds() - t0;
+    free(edges);
+    if (!graph) { printResult(GIRTH_NOMEM); return 1; }
+
+    printf("Graphe %s: %u sommets, %llu aretes distinctes (graine %u)\n", ring ? "cycle + cordes" : "aleatoire",
+           graph->n, (unsigned long long)(graph->m / 2), seed);
+    printf("Construction CSR: %.3f s, %.1f Mo\n", tBuild, csrMegabytes(graph));
+
+    int status = benchThreads(graph, maxThreads);
+    csr_free(graph);
+    return status;
+}
+
+// Points et droites du plan projectif PG(2,q): triplets normalises (1,a,b), (0,1,b), (0,0,1).
+// Le point P et la droite L sont relies si P.L = 0 mod q.
+static int runBenchProjective(int q, int maxThreads) {
+    if (q < 2) { printf("ERREUR: q premier >= 2\n"); return 1; }
+    for (int d = 2; d * d <= q; d++)
+        if (q % d == 0) { printf("ERREUR: q premier >= 2\n"); return 1; }
+    uint32_t np = (uint32_t)q * q + q + 1;
+    int (*pt)[3] = malloc(np * sizeof *pt);
+    Edge *edges = malloc((size_t)np * (q + 1) * sizeof(Edge));
+    if (!pt || !edges) { free(pt); free(edges); printResult(GIRTH_NOMEM); return 1; }
+    uint32_t c = 0;
+    for (int a = 0; a < q; a++)
+        for (int b = 0; b < q; b++) { pt[c][0] = 1; pt[c][1] = a; pt[c][2] = b; c++; }
+    for (int b = 0; b < q; b++) { pt[c][0] = 0; pt[c][1] = 1; pt[c][2] = b; c++; }
+    pt[c][0] = 0; pt[c][1] = 0; pt[c][2] = 1;
+
+    size_t m = 0;
+    for (uint32_t i = 0; i < np; i++)
+        for (uint32_t j = 0; j < np; j++)
+            if ((pt[i][0] * pt[j][0] + pt[i][1] * pt[j][1] + pt[i][2] * pt[j][2]) % q == 0) {
+                edges[m].u = i;
+                edges[m].v = np + j;
+                m++;
+            }
+    free(pt);
+
+    CsrGraph *graph = csr_from_edges(NULL, 2 * np, edges, m);
+    free(edges);
+    if (!graph) { printResult(GIRTH_NOMEM); return 1; }
+    printf("Plan projectif PG(2,%d): %u sommets, %llu aretes\n", q, graph->n,
+           (unsigned long long)(graph->m / 2));
+    int status = benchThreads(graph, maxThreads);
+    csr_free(graph);
+    return status;
+}
+
+// Grille L x H (sommet x + y*L), rues vers la droite et vers le bas gardees avec une
+// probabilite de 85%, longueur aleatoire de 1 a 1000: peu de voisins par sommet et des cycles
+// courts (les paves de maisons), comme un reseau routier
+static int runBenchRoad(uint32_t width, uint32_t height, unsigned seed, int maxThreads) {
+    if (width < 2 || height < 2 || (uint64_t)width * height > UINT32_MAX) {
+        printf("ERREUR: grille d'au moins 2 x 2 et de moins de 2^32 sommets\n");
+        return 1;
+    }
+    size_t cap = 2 * (size_t)width * height;
+    Edge *edges = malloc(cap * sizeof(Edge));
+    uint32_t *weights = malloc(cap * sizeof(uint32_t));
+    if (!edges || !weights) { free(edges); free(weights); printWeight(GIRTH_NOMEM); return 1; }
+    unsigned rng = seed ? seed : 1;
+    size_t m = 0;
+    for (uint32_t y = 0; y < height; y++)
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t v = x + y * width;
+            if (x + 1 < width && xorshift32(&rng) % 100 < 85) {
+                edges[m].u = v; edges[m].v = v + 1;
+                weights[m++] = 1 + xorshift32(&rng) % 1000;
+            }
+            if (y + 1 < height && xorshift32(&rng) % 100 < 85) {
+                edges[m].u = v; edges[m].v = v + width;
+                weights[m++] = 1 + xorshift32(&rng) % 1000;
+            }
+        }
+
+    double t0 = wall_seconds();
+    CsrGraph *graph = csr_from_edges_weighted(NULL, width * height, edges, weights, m, maxThreads);
+    double tBuild = wall_seconds() - t0;
+    free(edges);
+    free(weights);
+    if (!graph) { printWeight(GIRTH_NOMEM); return 1; }
+    printf("Reseau routier %u x %u: %u sommets, %llu aretes (graine %u)\n", width, height,
+           graph->n, (unsigned long long)(graph->m / 2), seed);
+    printf("Construction CSR ponderee: %.3f s, %.1f Mo\n", tBuild, csrMegabytes(graph));
+    int status = benchWeighted(graph, maxThreads);
+    csr_free(graph);
+    return status;
+}
+
+enum { LOAD_UNDIRECTED, LOAD_WEIGHTED, LOAD_DIRECTED };
+
+static CsrGraph *loadGraph(const char *path, int nthreads, uint32_t **ids, int kind) {
+    GirthLoadInfo info;
+    int weighted = kind == LOAD_WEIGHTED;
+    double t0 = wall_seconds();
+    CsrGraph *graph = weighted ? csr_load_weighted(NULL, path, nthreads, ids, &info)
+                    : kind == LOAD_DIRECTED ? csr_load_directed(NULL, path, nthreads, ids, &info)
+                    : csr_load(NULL, path, nthreads, ids, &info);
+    double dt = wall_seconds() - t0;
+    switch (info.status) {
+    case GIRTH_IO_FILE: printf("ERREUR: impossible de lire %s\n", path); break;
+    case GIRTH_IO_FORMAT:
+        if (info.line) printf("ERREUR: %s, ligne %llu: \"%s\" attendu\n", path,
+                              (unsigned long long)info.line, weighted ? "u v w" : "u v");
+        else if (weighted) printf("ERREUR: %s: le format binaire n'a pas de poids\n", path);
+        else printf("ERREUR: %s: fichier binaire tronque\n", path);
+        break;
+    case GIRTH_IO_NOMEM: printResult(GIRTH_NOMEM); break;
+    default:
+        printf("Fichier %s: %.1f Mo, %llu aretes lues, ids 0..%u\n", path, info.bytes / 1e6,
+               (unsigned long long)info.records, info.maxId);
+        printf("Graphe: %u sommets, %llu %s, %.1f Mo\n", graph->n,
+               (unsigned long long)(kind == LOAD_DIRECTED ? graph->m : graph->m / 2),
+               kind == LOAD_DIRECTED ? "arcs distincts" : "aretes distinctes", csrMegabytes(graph));
+        printf("Chargement (%d threads): %.3f s, %.0f Mo/s\n", nthreads, dt,
+               dt > 0 ? info.bytes / 1e6 / dt : 0.0);
+    }
+    return graph;
+}
+
+static int runLoad(const char *path, int maxThreads) {
+    uint32_t *ids;
+    CsrGraph *graph = loadGraph(path, maxThreads, &ids, LOAD_UNDIRECTED);
+    if (!graph) return 1;
+    uint32_t *cycle = malloc((graph->n > 0 ? graph->n : 1) * sizeof(uint32_t));
+    double t0 = wall_seconds();
+    int result = cycle ? shortestCycleWitness(graph, maxThreads, cycle) : GIRTH_NOMEM;
+    double dt = wall_seconds() - t0;
+    printResult(result);
+    if (result != GIRTH_NOMEM && result != INF) printCycle(graph, cycle, result, ids);
+    printf("Calcul (%d threads): %.3f s\n", maxThreads, dt);
+    free(cycle);
+    girth_free(NULL, ids);
+    csr_free(graph);
+    return result == GIRTH_NOMEM;
+}
+
+static int runWeighted(const char *path, int maxThreads) {
+    CsrGraph *graph = loadGraph(path, maxThreads, NULL, LOAD_WEIGHTED);
+    if (!graph) return 1;
+    double t0 = wall_seconds();
+    int64_t result = minimumWeightCycle(graph, maxThreads);
+    double dt = wall_seconds() - t0;
+    printWeight(result);
+    printf("Calcul (%d threads): %.3f s\n", maxThreads, dt);
+    csr_free(graph);
+    return result == GIRTH_NOMEM;
+}
+
+// Plus court cycle oriente (directed) ou impair
+static int runCycleKind(const char *path, int directed, int maxThreads) {
+    CsrGraph *graph = loadGraph(path, maxThreads, NULL, directed ? LOAD_DIRECTED : LOAD_UNDIRECTED);
+    if (!graph) return 1;
+    double t0 = wall_seconds();
+    int result = directed ? shortestDirectedCycle(graph, maxThreads) : shortestOddCycle(graph, maxThreads);
+    double dt = wall_seconds() - t0;
+    if (result == GIRTH_NOMEM) printResult(result);
+    else if (result == INF) printf(directed ? "Aucun cycle oriente (graphe acyclique)\n"
+                                            : "Aucun cycle impair (graphe biparti)\n");
+    else printf("Plus court cycle %s: %d %s\n", directed ? "oriente" : "impair", result,
+                directed ? "arcs" : "aretes");
+    printf("Calcul (%d threads): %.3f s\n", maxThreads, dt);
+    csr_free(graph);
+    return result == GIRTH_NOMEM;
+}
+
+// Mises a jour appliquees et affichees au fil de la lecture (utilisable sur un tube ou
+// /dev/stdin): le graphe s'agrandit quand un identifiant depasse les sommets connus
+static int runDynamic(const char *path, int maxThreads) {
+    FILE *in = fopen(path, "r");
+    if (!in) { printf("ERREUR: impossible de lire %s\n", path); return 1; }
+    GirthDynamic *D = girth_dynamic_create(NULL, 0, maxThreads);
+    if (!D) {
+        printResult(GIRTH_NOMEM);
+        fclose(in);
+        return 1;
+    }
+    char line[256];
+    unsigned long long lineNo = 0, count = 0, inserted = 0, deleted = 0;
+    int status = 0;
+    double dt = 0.0;
+    while (fgets(line, sizeof(line), in)) {
+        lineNo++;
+        char op;
+        unsigned long u, v;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+        if (sscanf(line, " %c %lu %lu", &op, &u, &v) != 3 || (op != '+' && op != '-') ||
+            u > UINT32_MAX - 1 || v > UINT32_MAX - 1) {
+            printf("ERREUR: %s, ligne %llu: \"+ u v\" ou \"- u v\" attendu\n", path, lineNo);
+            status = 1;
+            break;
+        }
+        double t0 = wall_seconds();
+        int r = girth_dynamic_reserve(D, (uint32_t)(u > v ? u : v) + 1);
+        if (r == 0) r = op == '+' ? girth_dynamic_insert(D, (uint32_t)u, (uint32_t)v)
+                                  : girth_dynamic_delete(D, (uint32_t)u, (uint32_t)v);
+        int girth = r == GIRTH_NOMEM ? r : girth_dynamic_girth(D);
+        dt += wall_seconds() - t0;
+        if (girth == GIRTH_NOMEM) { printResult(girth); status = 1; break; }
+        count++;
+        if (r == 1 && op == '+') inserted++;
+        if (r == 1 && op == '-') deleted++;
+        if (girth == INF) printf("%c %lu %lu -> aucun cycle\n", op, u, v);
+        else printf("%c %lu %lu -> %d\n", op, u, v, girth);
+        fflush(stdout);
+    }
+    fclose(in);
+    fprintf(stderr, "%llu mises a jour (%llu ajouts, %llu retraits effectifs), %llu recalculs complets\n",
+            count, inserted, deleted, (unsigned long long)girth_dynamic_recomputes(D));
+    fprintf(stderr, "Temps (%d threads): %.3f s, %.2f us par mise a jour\n", maxThreads, dt,
+            count ? dt * 1e6 / count : 0.0);
+    girth_dynamic_free(D);
+    return status;
+}
+
+static int endsWith(const char *s, const char *suffix) {
+    size_t n = strlen(s), k = strlen(suffix);
+    return n >= k && !strcmp(s + n - k, suffix);
+}
+
+static int runLocal(const char *path, const char *out, int maxThreads) {
+    uint32_t *ids;
+    CsrGraph *graph = loadGraph(path, maxThreads, &ids, LOAD_UNDIRECTED);
+    if (!graph) return 1;
+    int *local = malloc((graph->n > 0 ? graph->n : 1) * sizeof(int));
+    if (!local) { printResult(GIRTH_NOMEM); girth_free(NULL, ids); csr_free(graph); return 1; }
+
+    double t0 = wall_seconds();
+    int result = localGirth(graph, maxThreads, local);
+    double dt = wall_seconds() - t0;
+    int status = result == GIRTH_NOMEM;
+    printResult(result);
+    if (!status) {
+        uint32_t onCycle = 0;
+        int maxLocal = 0;
+        for (uint32_t v = 0; v < graph->n; v++) {
+            if (local[v] == INF) continue;
+            onCycle++;
+            if (local[v] > maxLocal) maxLocal = local[v];
+        }
+        printf("Maille locale (%d threads): %.3f s, %u sommets sur un cycle", maxThreads, dt, onCycle);
+        if (onCycle) printf(", de %d a %d aretes", result, maxLocal);
+        printf("\n");
+    }
+    if (!status && out) {
+        status = girth_save_local(out, graph->n, local, ids, endsWith(out, ".csv")) != GIRTH_IO_OK;
+        if (status) printf("ERREUR: impossible d'ecrire %s\n", out);
+        else printf("Ecrit: %s\n", out);
+    }
+    free(local);
+    girth_free(NULL, ids);
+    csr_free(graph);
+    return status;
+}
+
+static int runConvert(const char *in, const char *out, int maxThreads) {
+    uint32_t *ids;
+    CsrGraph *graph = loadGraph(in, maxThreads, &ids, LOAD_UNDIRECTED);
+    if (!graph) return 1;
+    int status = csr_save_binary(graph, out, ids);
+    if (status == GIRTH_IO_OK) printf("Ecrit: %s\n", out);
+    else printf("ERREUR: impossible d'ecrire %s\n", out);
+    girth_free(NULL, ids);
+    csr_free(graph);
+    return status != GIRTH_IO_OK;
+}
+
+// ============================================================
+//                  VERIFICATION (--check)
+// ============================================================
+
+#define CHECK_MAX_N 24            // sommets des graphes aleatoires verifies
+#define CHECK_BIG_EVERY 50        // un graphe sur CHECK_BIG_EVERY est grand:
+#define CHECK_BIG_MIN 65          //   de CHECK_BIG_MIN a CHECK_BIG_N sommets, plus d'un paquet
+#define CHECK_BIG_N 300           //   de 64 sources
+#define CHECK_SHOWN 10            // ecarts affiches au plus
+
+typedef struct {
+    unsigned long long checks, errors;
+} CheckTally;
+
+static void checkEqual(CheckTally *T, int graph, const char *what, int64_t got, int64_t want) {
+    T->checks++;
+    if (got == want) return;
+    if (T->errors++ < CHECK_SHOWN)
+        printf("ERREUR: graphe %d, %s: %lld au lieu de %lld\n", graph, what, (long long)got, (long long)want);
+}
+
+static int64_t edgeWeight(const CsrGraph *g, uint64_t k) {
+    return g->weight ? g->weight[k] : 1;
+}
+
+// Plus court chemin de u a v sans l'arete uv (Dijkstra en O(n^2), sans tas), GIRTH_WINF si
+// aucun. dist et done: n entrees.
+static int64_t bruteDetour(const CsrGraph *g, uint32_t u, uint32_t v, int64_t *dist, char *done) {
+    for (uint32_t i = 0; i < g->n; i++) {
+        dist[i] = GIRTH_WINF;
+        done[i] = 0;
+    }
+    dist[u] = 0;
+    for (;;) {
+        uint32_t x = UINT32_MAX;
+        for (uint32_t i = 0; i < g->n; i++)
+            if (!done[i] && dist[i] != GIRTH_WINF && (x == UINT32_MAX || dist[i] < dist[x])) x = i;
+        if (x == UINT32_MAX || x == v) break;
+        done[x] = 1;
+        for (uint64_t k = g->offsets[x]; k < g->offsets[x + 1]; k++) {
+            uint32_t y = g->adj[k];
+            if ((x == u && y == v) || (x == v && y == u)) continue;
+            if (dist[x] + edgeWeight(g, k) < dist[y]) dist[y] = dist[x] + edgeWeight(g, k);
+        }
+    }
+    return dist[v];
+}
+
+// Cycle de poids minimal (GIRTH_WINF si aucun) et local[v], le plus leger par chaque sommet:
+// le plus court cycle qui passe par l'arete uv est le detour de u a v, plus uv
+static int64_t bruteCycles(const CsrGraph *g, int64_t *local, int64_t *dist, char *done) {
+    int64_t best = GIRTH_WINF;
+    for (uint32_t v = 0; v < g->n; v++) local[v] = GIRTH_WINF;
+    for (uint32_t u = 0; u < g->n; u++)
+        for (uint64_t k = g->offsets[u]; k < g->offsets[u + 1]; k++) {
+            uint32_t v = g->adj[k];
+            if (v < u) continue;
+            int64_t d = bruteDetour(g, u, v, dist, done);
+            if (d == GIRTH_WINF) continue;
+            d += edgeWeight(g, k);
+            if (d < local[u]) local[u] = d;
+            if (d < local[v]) local[v] = d;
+            if (d < best) best = d;
+        }
+    return best;
+}
+
+static int64_t asGirth(int64_t w) {
+    return w == GIRTH_WINF ? INF : w;
+}
+
+// BFS de chaque source jusqu'a son retour: plus court cycle oriente (g de csr_from_arcs), ou
+// impair (odd: BFS sur le double revetement, etat 2v + parite de la longueur). INF si aucun.
+// dist et queue: 2n entrees.
+static int bruteReturn(const CsrGraph *g, int odd, int *dist, uint32_t *queue) {
+    int best = INF;
+    uint32_t states = odd ? 2 * g->n : g->n;
+    for (uint32_t s = 0; s < g->n; s++) {
+        for (uint32_t i = 0; i < states; i++) dist[i] = INF;
+        uint32_t head = 0, tail = 0;
+        dist[odd ? 2 * s : s] = 0;
+        queue[tail++] = odd ? 2 * s : s;
+        while (head < tail) {
+            uint32_t x = queue[head++], v = odd ? x / 2 : x;
+            for (uint64_t k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+                uint32_t w = g->adj[k];
+                if (!odd && w == s && dist[x] + 1 < best) best = dist[x] + 1;
+                uint32_t y = odd ? 2 * w + (x % 2 == 0) : w;
+                if (dist[y] == INF) {
+                    dist[y] = dist[x] + 1;
+                    queue[tail++] = y;
+                }
+            }
+        }
+        if (odd && dist[2 * s + 1] < best) best = dist[2 * s + 1];
+    }
+    return best;
+}
+
+// Flot aleatoire de 2n mises a jour sur un GirthDynamic parti de zero sommet, compare apres
+// chacune a la force brute sur les aretes presentes. present, edges: n*n entrees.
+static int checkDynamic(CheckTally *T, int graph, uint32_t n, int threads, unsigned *rng,
+                        char *present, Edge *edges, int64_t *local, int64_t *dist, char *done) {
+    GirthDynamic *D = girth_dynamic_create(NULL, 0, threads);
+    if (!D) return GIRTH_NOMEM;
+    memset(present, 0, (size_t)n * n);
+    for (uint32_t step = 0; step < 2 * n; step++) {
+        uint32_t u = xorshift32(rng) % n, v = xorshift32(rng) % n;
+        int del = present[u * n + v] && xorshift32(rng) % 3 != 0;
+        int r = girth_dynamic_reserve(D, (u > v ? u : v) + 1);
+        if (r == 0) r = del ? girth_dynamic_delete(D, u, v) : girth_dynamic_insert(D, u, v);
+        if (r == GIRTH_NOMEM) { girth_dynamic_free(D); return r; }
+        if (r == 1) present[u * n + v] = present[v * n + u] = !del;
+        size_t m = 0;
+        for (uint32_t a = 0; a < n; a++)
+            for (uint32_t b = a + 1; b < n; b++)
+                if (present[a * n + b]) {
+                    edges[m].u = a;
+                    edges[m].v = b;
+                    m++;
+                }
+        CsrGraph *g = csr_from_edges(NULL, n, edges, m);
+        if (!g) { girth_dynamic_free(D); return GIRTH_NOMEM; }
+        checkEqual(T, graph, "girth_dynamic_girth", girth_dynamic_girth(D),
+                   asGirth(bruteCycles(g, local, dist, done)));
+        csr_free(g);
+    }
+    girth_dynamic_free(D);
+    return 0;
+}
+
+// Grand graphe dont les plus courts cycles evitent les premieres sources: un arbre ou chaque
+// noeud interne a 3 fils (plus de 64 sommets de degre 4 des que n >= 210, sans cycle) et, a
+// part, un anneau de 3 a 12 sommets avec 0 a 2 cordes. Les sommets sont renumerotes au hasard
+// (perm: n entrees). Renvoie le nombre d'aretes.
+static size_t treeAndRing(Edge *edges, uint32_t n, unsigned *rng, uint32_t *perm) {
+    uint32_t ring = 3 + xorshift32(rng) % 10, tree = n - ring;
+    size_t m = 0;
+    for (uint32_t v = 0; v < n; v++) perm[v] = v;
+    for (uint32_t v = n - 1; v > 0; v--) {
+        uint32_t j = xorshift32(rng) % (v + 1), t = perm[v];
+        perm[v] = perm[j];
+        perm[j] = t;
+    }
+    for (uint32_t v = 1; v < tree; v++) {
+        edges[m].u = perm[(v - 1) / 3];
+        edges[m].v = perm[v];
+        m++;
+    }
+    for (uint32_t i = 0; i < ring; i++) {
+        edges[m].u = perm[tree + i];
+        edges[m].v = perm[tree + (i + 1) % ring];
+        m++;
+    }
+    for (uint32_t c = xorshift32(rng) % 3; c > 0; c--) {
+        edges[m].u = perm[tree + xorshift32(rng) % ring];
+        edges[m].v = perm[tree + xorshift32(rng) % ring];
+        m++;
+    }
+    return m;
+}
+
+// count graphes aleatoires: chaque moteur est compare a la force brute ci-dessus. Les petits
+// (au plus CHECK_MAX_N sommets) passent avec 1 a max(T, 4) threads, un seul nombre par graphe,
+// et par le GirthDynamic. Les grands (un sur CHECK_BIG_EVERY) passent avec chacun de ces
+// nombres de threads, sans le GirthDynamic (2n forces brutes y seraient trop longues): ils
+// exercent plusieurs paquets de GIRTH_CHUNK sources, l'exclusion par rang d'un lot de 64
+// sources a l'autre dans BitParallel et la borne partagee entre paquets (les arbres plus un
+// anneau placent le plus court cycle loin des premieres sources). Le passage d'un paquet
+// d'un thread a l'autre depend de l'ordonnanceur: il n'est vraiment exerce qu'avec plusieurs
+// coeurs. Un septieme des graphes est biparti (aucun cycle impair).
+static int runCheck(int count, unsigned seed, int maxThreads) {
+    size_t nn = (size_t)CHECK_BIG_N * CHECK_BIG_N;
+    Edge *edges = malloc(nn * sizeof(Edge));
+    uint32_t *weights = malloc(nn * sizeof(uint32_t));
+    char *present = malloc(nn), *done = malloc(CHECK_BIG_N);
+    int64_t *local64 = malloc(CHECK_BIG_N * sizeof(int64_t)), *dist64 = malloc(CHECK_BIG_N * sizeof(int64_t));
+    int *local = malloc(CHECK_BIG_N * sizeof(int)), *dist = malloc(2 * CHECK_BIG_N * sizeof(int));
+    uint32_t *queue = malloc(2 * CHECK_BIG_N * sizeof(uint32_t)), *cycle = malloc(CHECK_BIG_N * sizeof(uint32_t));
+    int nomem = !edges || !weights || !present || !done || !local64 || !dist64 || !local || !dist ||
+                !queue || !cycle;
+    unsigned rng = seed ? seed : 1;
+    int spread = maxThreads > 4 ? maxThreads : 4;
+    CheckTally T = { 0, 0 };
+    double t0 = wall_seconds();
+
+    for (int it = 0; it < count && !nomem; it++) {
+        // un grand graphe sur deux est un arbre plus un anneau (treeAndRing)
+        int big = it % CHECK_BIG_EVERY == CHECK_BIG_EVERY - 1;
+        int shaped = big && it / CHECK_BIG_EVERY % 2 == 1;
+        uint32_t n = shaped ? CHECK_BIG_N - xorshift32(&rng) % (CHECK_BIG_N / 4)
+                   : big ? CHECK_BIG_MIN + xorshift32(&rng) % (CHECK_BIG_N - CHECK_BIG_MIN + 1)
+                   : 1 + xorshift32(&rng) % CHECK_MAX_N;
+        size_t m = shaped ? treeAndRing(edges, n, &rng, queue) : xorshift32(&rng) % (2 * n + 2);
+        int bipartite = it % 7 == 0 && !shaped, threads = 1 + it % spread;
+        for (size_t e = 0; e < m; e++) {
+            if (!shaped) {
+                edges[e].u = xorshift32(&rng) % n;
+                edges[e].v = xorshift32(&rng) % n;
+            }
+            if (bipartite) {              // pairs - impairs (boucle, donc ignoree, sinon)
+                edges[e].u &= ~1u;
+                edges[e].v |= 1u;
+                if (edges[e].v >= n) edges[e].v = edges[e].u;
+            }
+            // poids nuls et egaux, moyens, ou jusqu'a 2^32 - 1 selon le graphe
+            weights[e] = it % 3 == 0 ? xorshift32(&rng) % 3
+                       : it % 3 == 1 ? 1 + xorshift32(&rng) % 1000 : xorshift32(&rng);
+        }
+        CsrGraph *g = csr_from_edges_parallel(NULL, n, edges, m, threads);
+        CsrGraph *wg = csr_from_edges_weighted(NULL, n, edges, weights, m, threads);
+        CsrGraph *arcs = csr_from_arcs(NULL, n, edges, m, threads);
+        nomem = !g || !wg || !arcs;
+        if (!nomem) {
+            // le poids d'abord: local64 garde ensuite les cycles locaux du graphe sans poids
+            int64_t weight = bruteCycles(wg, local64, dist64, done);
+            int girth = (int)asGirth(bruteCycles(g, local64, dist64, done));
+            int odd = bruteReturn(g, 1, dist, queue), directed = bruteReturn(arcs, 0, dist, queue);
+            checkEqual(&T, it, "shortestCycle", shortestCycle(g), girth);
+            for (int t = big ? 1 : threads; t <= (big ? spread : threads); t++) {
+                checkEqual(&T, it, "shortestCycleParallel", shortestCycleParallel(g, t), girth);
+                checkEqual(&T, it, "shortestCycleBitParallel", shortestCycleBitParallel(g, t), girth);
+                int len = shortestCycleWitness(g, t, cycle);
+                checkEqual(&T, it, "shortestCycleWitness", len, girth);
+                if (len != INF && len != GIRTH_NOMEM)
+                    checkEqual(&T, it, "girth_is_cycle (temoin)", girth_is_cycle(g, cycle, len), 1);
+                checkEqual(&T, it, "localGirth", localGirth(g, t, local), girth);
+                for (uint32_t v = 0; v < n; v++)
+                    checkEqual(&T, it, "localGirth (un sommet)", local[v], asGirth(local64[v]));
+                checkEqual(&T, it, "shortestOddCycle", shortestOddCycle(g, t), odd);
+                checkEqual(&T, it, "shortestDirectedCycle", shortestDirectedCycle(arcs, t), directed);
+                checkEqual(&T, it, "minimumWeightCycle", minimumWeightCycle(wg, t), weight);
+            }
+            if (!big)
+                nomem = checkDynamic(&T, it, n, threads, &rng, present, edges, local64, dist64, done) != 0;
+        }
+        csr_free(g);
+        csr_free(wg);
+        csr_free(arcs);
+    }
+
+    if (nomem) printResult(GIRTH_NOMEM);
+    else printf("%d graphes (graine %u, au plus %d sommets, un sur %d de %d a %d): %llu verifications, "
+                "%llu ecarts, %.3f s\n", count, seed, CHECK_MAX_N, CHECK_BIG_EVERY, CHECK_BIG_MIN,
+                CHECK_BIG_N, T.checks, T.errors, wall_seconds() - t0);
+    free(edges); free(weights); free(present); free(done); free(local64); free(dist64);
+    free(local); free(dist); free(queue); free(cycle);
+    return nomem || T.errors != 0;
+}
+
+// ============================================================
+//                         MAIN
+// ============================================================
+
+int main(int argc, char **argv) {
+    int maxThreads = cpuCount();
+    // --threads T, a n'importe quelle position
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--threads")) {
+            maxThreads = atoi(argv[i + 1]);
+            if (maxThreads < 1) maxThreads = 1;
+            for (int j = i; j + 2 < argc; j++) argv[j] = argv[j + 2];
+            argc -= 2;
+            break;
+        }
+    }
+
+    if (argc >= 3 && !strcmp(argv[1], "--load"))
+        return runLoad(argv[2], maxThreads);
+    if (argc >= 3 && !strcmp(argv[1], "--dynamic"))
+        return runDynamic(argv[2], maxThreads);
+    if (argc >= 3 && !strcmp(argv[1], "--weighted"))
+        return runWeighted(argv[2], maxThreads);
+    if (argc >= 3 && (!strcmp(argv[1], "--directed") || !strcmp(argv[1], "--odd")))
+        return runCycleKind(argv[2], !strcmp(argv[1], "--directed"), maxThreads);
+    if (argc >= 4 && !strcmp(argv[1], "--bench-road")) {
+        unsigned seed = argc >= 5 ? (unsigned)strtoul(argv[4], NULL, 10) : 1;
+        return runBenchRoad((uint32_t)strtoul(argv[2], NULL, 10),
+                            (uint32_t)strtoul(argv[3], NULL, 10), seed, maxThreads);
+    }
+    if (argc >= 3 && !strcmp(argv[1], "--local"))
+        return runLocal(argv[2], argc >= 4 ? argv[3] : NULL, maxThreads);
+    if (argc >= 4 && !strcmp(argv[1], "--convert"))
+        return runConvert(argv[2], argv[3], maxThreads);
+    if (argc >= 3 && !strcmp(argv[1], "--check"))
+        return runCheck(atoi(argv[2]), argc >= 4 ? (unsigned)strtoul(argv[3], NULL, 10) : 1, maxThreads);
+    if (argc >= 3 && !strcmp(argv[1], "--bench-pg"))
+        return runBenchProjective(atoi(argv[2]), maxThreads);
+    int ring = argc >= 2 && !strcmp(argv[1], "--bench-ring");
+    if (argc >= 4 && (ring || !strcmp(argv[1], "--bench"))) {
+        unsigned seed = argc >= 5 ? (unsigned)strtoul(argv[4], NULL, 10) : 1;
+        return runBench((uint32_t)strtoul(argv[2], NULL, 10), (size_t)strtoull(argv[3], NULL, 10),
+                        seed, ring, maxThreads);
+    }
+    if (argc > 1) {
+        printf("Usage: %s [--bench V E [graine] | --bench-ring V C [graine] | --bench-pg q |\n"
+               "          --bench-road L H [graine] | --load fichier | --weighted fichier |\n"
+               "          --directed fichier | --odd fichier | --dynamic fichier |\n"
+               "          --convert texte binaire | --local fichier [sortie] | --check N [graine]]\n"
+               "          [--threads T]\n",
+               argv[0]);
+        return 1;
+    }
+    return runExample();
+}
@@ -1,244 +1,1188 @@
 /* tsp_compare.c
- * Compilation: gcc -O2 -std=c99 tsp_compare.c -o tsp_compare -lm
+ * Compilation: make   (ou gcc -O2 -std=c99 main.c tsp.c -o tsp_compare -lm -pthread)
+ * Les solveurs sont dans la bibliothèque tsp.h / tsp.c (libtsp.a, libtsp.so); ce programme
+ * n'en est qu'un client: mesures, comparaisons et mode service.
  *
- * Usage: ./tsp_compare
+ * Usage: ./tsp_compare                       (benchmark sur graphes aléatoires)
+ *        ./tsp_compare fichier.tsp [optimum]  (instance TSPLIB, optimum vérifié)
+ *        ./tsp_compare --bench-simd           (Held-Karp scalaire vs SIMD, n = 16..24)
+ *        ./tsp_compare --bench [base.csv]     (banc d'essai: mediane/MAD, CSV/JSON, regression)
+ *        ./tsp_compare --bench-fixed          (Held-Karp generique vs specialise, n = 4..16)
+ *        ./tsp_compare --hk-ooc n [dossier]   (Held-Karp hors memoire, couches sur disque)
+ *        ./tsp_compare --serve [socket]       (service: flux d'instances, pool de threads)
  *
  * Le programme:
- * - génère des graphes complets (matrices de distances symétriques)
+ * - génère des graphes complets (matrices de distances symétriques, puis asymétriques)
  * - pour chaque n de MIN_N à MAX_N:
  *     - lance la méthode exacte (permutations) si n <= MAX_EXACT_N
+ *       (backtracking à coût porté, ou algorithme de Heap à mise à jour O(1))
  *     - lance Held-Karp (DP bitmask)
- *     - mesure les temps CPU (clock())
- * - affiche un tableau comparatif (n, temps_exact, temps_HK, coût trouvé)
+ *     - calcule la borne inférieure du 1-arbre (relaxation lagrangienne) et l'écart
+ *     - lance l'heuristique plus proche voisin + 2-opt / Or-opt
+ * - Held-Karp par couches (rang colex): mémoire utilisée par n, table complète vs couches
+ * - ATSP: solveurs exacts et borne de l'affectation, puis fenêtres de temps et précédences
+ * - puis, pour de grandes instances euclidiennes (LARGE_SIZES), l'heuristique seule
+ * - enfin Lin-Kernighan itéré multi-thread: validation contre Held-Karp (n <= MAX_N)
+ *   et chronologie des améliorations sur LK_LARGE_N villes avec un budget de temps
+ * - mesure les temps par le banc d'essai (horloge monotone, échauffement, médiane / MAD) et
+ *   vérifie que tous les solveurs exacts trouvent le même optimum
+ * - affiche un tableau comparatif (n, temps_exact, temps_HK, coût trouvé, borne, écart,
+ *   temps et coût de l'heuristique)
  *
  * ATTENTION: la méthode exacte explose en factorielle. MAX_EXACT_N est petit (<=11).
  */
 
+#define _POSIX_C_SOURCE 200809L   /* fdopen, dup */
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 #include <limits.h>
+#include <stdint.h>
 #include <string.h>
-
-#define INFLL LLONG_MAX/4
+#include <math.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include "tsp.h"
 
 /* Paramètres que vous pouvez ajuster */
 #define SEED 123456
 #define MIN_N 2
 #define MAX_N 12           /* test jusqu'à 12 (Held-Karp OK, exact lourd) */
 #define MAX_EXACT_N 10     /* exécution exacte autorisée (n! croît vite) */
-#define TRIALS 3           /* répétitions pour moyennes de temps */
+#define TRIALS 3           /* instances par n (chacune mesurée par le banc d'essai) */
 #define MAX_DIST 100
+#define LARGE_SIZES { 1000, 10000, 100000 }  /* instances euclidiennes pour l'heuristique */
+#define LK_TIME_BUDGET 2.0    /* secondes (horloge murale) pour la démonstration */
+#define LK_THREADS 4
+#define LK_VALIDATE_BUDGET 0.05   /* secondes par instance validée contre Held-Karp */
+#define LK_LARGE_N 10000
+
+/* Générateur des instances de test (thread principal seulement; le mode service n'en génère pas) */
+static TspContext ctx;
+
+/* ---------- Variantes de Held-Karp: mesures dédiées ---------- */
+
+#define SIMD_BENCH_MIN_N 16
+#define SIMD_BENCH_MAX_N 24
+#define FIXED_BENCH_TIME 0.2    /* secondes de mesure par n et par version */
+
+/* Compare held_karp (push scalaire) et held_karp_simd pour n = SIMD_BENCH_MIN_N..MAX_N */
+void bench_held_karp_simd() {
+    printf("Held-Karp: push scalaire vs pull min-plus (%s)\n\n", held_karp_simd_kernel());
+    printf(" n | scalar(s) |  simd(s)  | speedup | cout\n");
+    printf("------------------------------------------------\n");
+    for (int n=SIMD_BENCH_MIN_N; n<=SIMD_BENCH_MAX_N; n++) {
+        DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
+        double s = wall_seconds();
+        long long c1 = held_karp(d);
+        double t1 = wall_seconds() - s;
+        s = wall_seconds();
+        long long c2 = held_karp_simd(d);
+        double t2 = wall_seconds() - s;
+        printf("%2d | %9.3f | %9.3f | %6.1fx | %lld %s\n", n, t1, t2, t1 / t2, c2,
+               c1 == c2 ? "OK" : "ERREUR");
+        dm_free(d);
+    }
+}
+
+/* Held-Karp hors mémoire sur un graphe aléatoire de n villes, couches dans 'dir'.
+ * Vérifie le résultat contre la DP en mémoire tant que celle-ci reste raisonnable.
+ */
+int bench_held_karp_ooc(int n, const char *dir) {
+    if (n < MIN_N) n = MIN_N;
+    tsp_context_init(&ctx, SEED);
+    DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
+    size_t disk = 0;
+    double s = wall_seconds();
+    long long c = held_karp_out_of_core(d, dir, &disk);
+    double t = wall_seconds() - s;
+    if (c < 0) { dm_free(d); return 1; }
+    printf("Held-Karp hors memoire: n=%d, cout=%lld, temps=%.3f s, disque max=%.1f Mo\n",
+           n, c, t, disk / (1024.0 * 1024.0));
+    int status = 0;
+    if (n <= SIMD_BENCH_MAX_N) {
+        long long ref = held_karp_simd(d);
+        printf("Held-Karp en memoire: cout=%lld %s\n", ref, ref == c ? "OK" : "ERREUR");
+        status = ref == c ? 0 : 2;
+    }
+    dm_free(d);
+    return status;
+}
+
+/* Latence par instance pour n = 4..16: version générique contre version spécialisée.
+ * Chaque version est répétée sur la même instance pendant FIXED_BENCH_TIME secondes.
+ */
+void bench_held_karp_fixed() {
+    printf("Held-Karp: generique vs specialise a la compilation (latence par instance)\n\n");
+    printf(" n | generique(us) | specialise(us) | acceleration | cout\n");
+    printf("------------------------------------------------------------\n");
+    for (int n=HK_FIXED_MIN_N; n<=HK_FIXED_MAX_N; n++) {
+        DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
+        long long c1 = 0, c2 = 0;
+        long long reps1 = 0, reps2 = 0;
+        double s = wall_seconds(), t1, t2;
+        do { c1 = held_karp(d); reps1++; } while ((t1 = wall_seconds() - s) < FIXED_BENCH_TIME);
+        s = wall_seconds();
+        do { c2 = held_karp_fixed(d); reps2++; } while ((t2 = wall_seconds() - s) < FIXED_BENCH_TIME);
+        double u1 = 1e6 * t1 / reps1, u2 = 1e6 * t2 / reps2;
+        printf("%2d | %13.2f | %14.2f | %11.1fx | %lld %s\n", n, u1, u2, u1 / u2, c2,
+               c1 == c2 ? "OK" : "ERREUR");
+        dm_free(d);
+    }
+}
+
+/* ---------- Banc d'essai: répétitions adaptatives, médiane / MAD, référence ---------- */
+
+/* Chaque mesure:
+ * - horloge monotone (wall_seconds), pas clock() qui mesure le temps CPU du processus;
+ * - échauffement + calibration: les appels sont groupés par lots d'au moins BENCH_MIN_SAMPLE
+ *   secondes (les petits n durent moins que la résolution de l'horloge);
+ * - répétitions jusqu'à ce que l'intervalle de confiance à 95 % de la médiane soit plus étroit
+ *   que BENCH_CI_REL (relatif), dans la limite de BENCH_MAX_REPS / BENCH_MAX_TIME;
+ * - on retient la médiane et l'écart absolu médian (MAD), robustes aux interruptions.
+ * L'IC est estimé par 1.96 * 1.2533 * sigma / sqrt(k), avec sigma = 1.4826 * MAD.
+ */
+
+#define BENCH_MIN_SAMPLE 1e-4
+#define BENCH_MIN_REPS 5
+#define BENCH_MAX_REPS 200
+#define BENCH_MAX_TIME 1.0
+#define BENCH_CI_REL 0.02
+#define BENCH_MAX_N 16
+#define BENCH_SPINUP 0.5        /* échauffement global (fréquence CPU, caches) en secondes */
+#define BENCH_REGRESSION 0.25   /* médiane > référence * 1.25: régression (même machine) */
+#define BENCH_CSV "bench.csv"
+#define BENCH_JSON "bench.json"
+
+typedef long long (*bench_solver)(const DistMatrix *d);
 
-/* ---------- utilitaires ---------- */
+typedef struct {
+    const char *solver;
+    int n;
+    int reps;             /* échantillons retenus */
+    int batch;            /* appels par échantillon */
+    double median, mad;   /* secondes par appel */
+    double ci;            /* demi-largeur relative de l'IC 95 % de la médiane */
+    long long cost;
+} BenchStat;
 
-long long **alloc_matrix_int(int n) {
-    long long **m = malloc(n * sizeof(long long*));
-    for (int i=0;i<n;i++){
-        m[i] = malloc(n * sizeof(long long));
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Médiane de v[0..k-1] (v est trié au passage) */
+static double median_of(double *v, int k) {
+    qsort(v, k, sizeof(double), cmp_double);
+    return k % 2 ? v[k/2] : 0.5 * (v[k/2 - 1] + v[k/2]);
+}
+
+BenchStat bench_measure(const char *name, bench_solver f, const DistMatrix *d) {
+    BenchStat B = { name, d->n, 0, 1, 0.0, 0.0, 0.0, -1 };
+    /* échauffement et calibration du lot */
+    for (;;) {
+        double s = wall_seconds();
+        for (int i=0;i<B.batch;i++) B.cost = f(d);
+        if (wall_seconds() - s >= BENCH_MIN_SAMPLE || B.batch >= (1 << 20)) break;
+        B.batch *= 2;
+    }
+    double samples[BENCH_MAX_REPS], tmp[BENCH_MAX_REPS];
+    double start = wall_seconds();
+    while (B.reps < BENCH_MAX_REPS) {
+        double s = wall_seconds();
+        for (int i=0;i<B.batch;i++) B.cost = f(d);
+        samples[B.reps++] = (wall_seconds() - s) / B.batch;
+        if (B.reps < BENCH_MIN_REPS) continue;
+        memcpy(tmp, samples, B.reps * sizeof(double));
+        B.median = median_of(tmp, B.reps);
+        for (int i=0;i<B.reps;i++) tmp[i] = fabs(samples[i] - B.median);
+        B.mad = median_of(tmp, B.reps);
+        B.ci = B.median > 0 ? 1.96 * 1.2533 * 1.4826 * B.mad / sqrt((double)B.reps) / B.median : 0.0;
+        if (B.ci <= BENCH_CI_REL || wall_seconds() - start > BENCH_MAX_TIME) break;
     }
-    return m;
+    return B;
 }
-void free_matrix_int(long long **m, int n){
-    for (int i=0;i<n;i++) free(m[i]);
-    free(m);
+
+static long long bench_layered(const DistMatrix *d) {
+    return held_karp_layered(d, NULL, NULL);
+}
+
+static long long bench_mitm(const DistMatrix *d) {
+    return held_karp_mitm(d, NULL);
+}
+
+static long long bench_local_search(const DistMatrix *d) {
+    TspInstance I = instance_from_matrix(d);
+    int *tour = malloc(d->n * sizeof(int));
+    long long c = tsp_local_search(&I, tour);
+    free(tour);
+    return c;
 }
 
-/* Génère une matrice de distances symétrique avec diagonale 0 */
-long long **generate_random_complete_graph(int n) {
-    long long **d = alloc_matrix_int(n);
-    for (int i=0;i<n;i++){
-        for (int j=0;j<n;j++){
-            if (i==j) d[i][j]=0;
-            else if (j<i) d[i][j]=d[j][i];
-            else d[i][j] = 1 + rand()%MAX_DIST;
+typedef struct {
+    const char *name;
+    bench_solver fn;
+    int max_n;
+    int exact;            /* doit trouver l'optimum (sinon: coût >= optimum) */
+} BenchSolver;
+
+static const BenchSolver bench_solvers[] = {
+    { "exact", tsp_exact, MAX_EXACT_N, 1 },
+    { "exact_heap", tsp_exact_heap, MAX_EXACT_N, 1 },
+    { "held_karp", held_karp, BENCH_MAX_N, 1 },
+    { "held_karp_fixed", held_karp_fixed, BENCH_MAX_N, 1 },
+    { "held_karp_simd", held_karp_simd, BENCH_MAX_N, 1 },
+    { "held_karp_layered", bench_layered, BENCH_MAX_N, 1 },
+    { "held_karp_mitm", bench_mitm, BENCH_MAX_N, 1 },
+    { "2opt_oropt", bench_local_search, BENCH_MAX_N, 0 },
+};
+#define BENCH_NSOLVERS ((int)(sizeof(bench_solvers) / sizeof(bench_solvers[0])))
+
+/* Vérifie que les solveurs exacts s'accordent et qu'aucune heuristique ne fait mieux */
+static int bench_agree(const BenchStat *S, const int *exact, int k) {
+    long long opt = -1;
+    for (int i=0;i<k;i++)
+        if (exact[i]) {
+            if (opt < 0) opt = S[i].cost;
+            else if (S[i].cost != opt) return 0;
+        }
+    for (int i=0;i<k;i++) if (!exact[i] && opt >= 0 && S[i].cost < opt) return 0;
+    return 1;
+}
+
+int bench_write_csv(const char *path, const BenchStat *S, int k) {
+    FILE *f = fopen(path, "w");
+    if (!f) { perror(path); return -1; }
+    fprintf(f, "solver,n,reps,batch,median_s,mad_s,ci_rel,cost\n");
+    for (int i=0;i<k;i++)
+        fprintf(f, "%s,%d,%d,%d,%.9g,%.9g,%.4f,%lld\n", S[i].solver, S[i].n, S[i].reps, S[i].batch,
+                S[i].median, S[i].mad, S[i].ci, S[i].cost);
+    fclose(f);
+    return 0;
+}
+
+int bench_write_json(const char *path, const BenchStat *S, int k) {
+    FILE *f = fopen(path, "w");
+    if (!f) { perror(path); return -1; }
+    fprintf(f, "[\n");
+    for (int i=0;i<k;i++)
+        fprintf(f, "  {\"solver\": \"%s\", \"n\": %d, \"reps\": %d, \"batch\": %d, \"median_s\": %.9g, "
+                "\"mad_s\": %.9g, \"ci_rel\": %.4f, \"cost\": %lld}%s\n", S[i].solver, S[i].n, S[i].reps,
+                S[i].batch, S[i].median, S[i].mad, S[i].ci, S[i].cost, i + 1 < k ? "," : "");
+    fprintf(f, "]\n");
+    fclose(f);
+    return 0;
+}
+
+/* Compare aux médianes d'un CSV de référence (même format). Une régression exige que la
+ * médiane dépasse la référence de plus de BENCH_REGRESSION, même en tenant compte des deux
+ * intervalles de confiance. Renvoie le nombre de régressions, -1 si le fichier est illisible.
+ */
+int bench_compare_baseline(const char *path, const BenchStat *S, int k) {
+    FILE *f = fopen(path, "r");
+    if (!f) { perror(path); return -1; }
+    char line[256];
+    int regressions = 0;
+    printf("\nComparaison a la reference %s (seuil +%.0f%%)\n\n", path, 100.0 * BENCH_REGRESSION);
+    printf(" %-18s |  n | reference(s) |  actuel(s)  | ratio | verdict\n", "solveur");
+    printf("--------------------------------------------------------------------------\n");
+    if (!fgets(line, sizeof(line), f)) { fclose(f); return 0; }   /* en-tête */
+    while (fgets(line, sizeof(line), f)) {
+        char solver[64];
+        int n;
+        double med, ci;
+        if (sscanf(line, "%63[^,],%d,%*d,%*d,%lf,%*f,%lf", solver, &n, &med, &ci) != 4) continue;
+        for (int i=0;i<k;i++) {
+            if (S[i].n != n || strcmp(S[i].solver, solver)) continue;
+            double ratio = med > 0 ? S[i].median / med : 1.0;
+            /* régression: au-delà du seuil, et intervalles de confiance disjoints */
+            int slow = ratio > 1.0 + BENCH_REGRESSION
+                       && S[i].median * (1.0 - S[i].ci) > med * (1.0 + ci) * (1.0 + BENCH_REGRESSION);
+            regressions += slow;
+            printf(" %-18s | %2d | %12.6g | %11.6g | %5.2f | %s\n", solver, n, med, S[i].median, ratio,
+                   slow ? "REGRESSION" : ratio < 1.0 - BENCH_REGRESSION ? "plus rapide" : "stable");
         }
     }
-    return d;
+    fclose(f);
+    return regressions;
 }
 
-/* Calcule le coût d'un cycle: 0 -> perm[0] -> perm[1] -> ... -> perm[m-1] -> 0
- * Ici perm contient les villes visitées après 0 (par ex. {1,3,2,4}).
+/* ./tsp_compare --bench [reference.csv]: tous les solveurs exacts pour n = 4..BENCH_MAX_N,
+ * export CSV/JSON, comparaison éventuelle à une référence.
+ * Renvoie 0, 2 si les solveurs se contredisent, 3 en cas de régression.
  */
-long long cycle_cost_from_perm(long long **d, int n, int *perm, int m) {
-    long long cost = 0;
-    int prev = 0;
-    for (int i=0;i<m;i++) {
-        int cur = perm[i];
-        cost += d[prev][cur];
-        prev = cur;
+int run_benchmark_suite(const char *baseline) {
+    BenchStat *all = malloc((BENCH_MAX_N + 1) * BENCH_NSOLVERS * sizeof(BenchStat));
+    int count = 0, status = 0;
+    /* les premières mesures d'un processus sont plus lentes: on fait tourner la machine avant */
+    DistMatrix *w = generate_random_complete_graph(&ctx, BENCH_MAX_N, MAX_DIST);
+    for (double s = wall_seconds(); wall_seconds() - s < BENCH_SPINUP; ) held_karp(w);
+    dm_free(w);
+    printf("Banc d'essai: mediane / MAD par appel (IC 95%% <= %.0f%%, %d a %d repetitions)\n\n",
+           100.0 * BENCH_CI_REL, BENCH_MIN_REPS, BENCH_MAX_REPS);
+    printf(" %-18s |  n | mediane(s)  |   MAD(s)    | IC(%%) | reps | cout\n", "solveur");
+    printf("-------------------------------------------------------------------------------\n");
+    for (int n=4; n<=BENCH_MAX_N; n++) {
+        DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
+        int first = count;
+        int exact[BENCH_NSOLVERS];
+        for (int s=0; s<BENCH_NSOLVERS; s++) {
+            if (n > bench_solvers[s].max_n) continue;
+            BenchStat B = bench_measure(bench_solvers[s].name, bench_solvers[s].fn, d);
+            exact[count - first] = bench_solvers[s].exact;
+            all[count++] = B;
+            printf(" %-18s | %2d | %11.6g | %11.6g | %5.2f | %4d | %lld\n", B.solver, n, B.median, B.mad,
+                   100.0 * B.ci, B.reps, B.cost);
+        }
+        if (!bench_agree(all + first, exact, count - first)) {
+            printf(" n=%d: DESACCORD entre solveurs\n", n);
+            status = 2;
+        }
+        dm_free(d);
+    }
+    /* comparaison avant l'export: la référence peut être le fichier que l'on va réécrire */
+    if (baseline) {
+        int r = bench_compare_baseline(baseline, all, count);
+        if (r > 0 && status == 0) status = 3;
     }
-    cost += d[prev][0]; /* retour à 0 */
-    return cost;
+    if (baseline && strcmp(baseline, BENCH_CSV) == 0) {
+        if (bench_write_json(BENCH_JSON, all, count) == 0)
+            printf("\nResultats: %s (reference %s conservee)\n", BENCH_JSON, BENCH_CSV);
+    } else if (bench_write_csv(BENCH_CSV, all, count) == 0 && bench_write_json(BENCH_JSON, all, count) == 0)
+        printf("\nResultats: %s, %s\n", BENCH_CSV, BENCH_JSON);
+    free(all);
+    return status;
 }
 
-/* ---------- Méthode exacte: énumération des permutations par backtracking ---------- */
+/* ---------- Mesure de temps et comparaisons ---------- */
 
-/* Variables globales utilisées pour la recherche exhaustive */
-long long exact_best_cost;
-int *exact_best_perm;
-int *used_global;
+#define LAYERED_MAX_N 20
 
-/* backtrack_perm:
- * - perm: tableau courant d'ordre des villes (taille m = depth)
- * - depth: profondeur actuelle (= nombre de villes déjà placées)
- * - n: nombre total de villes
+/* Mémoire de Held-Karp: table complète 2^n x n contre couches k-1 et k (coût seul), puis
+ * avec les points de contrôle nécessaires à la tournée, et contre la rencontre au milieu.
+ * Vérifie coût et tournée.
  */
-void backtrack_perm(long long **d, int n, int *perm, int depth) {
-    if (depth == n-1) {
-        /* perm est complet : calcule coût total du cycle */
-        long long cost = cycle_cost_from_perm(d, n, perm, n-1);
-        if (cost < exact_best_cost) {
-            exact_best_cost = cost;
-            for (int i=0;i<n-1;i++) exact_best_perm[i] = perm[i];
+void report_held_karp_layers() {
+    printf("\nHeld-Karp par couches: memoire utilisee (octets)\n\n");
+    printf(" n |    table_dp |     couches | couches+tour | layer_time(s) |        mitm | mitm_time(s) | cout | note\n");
+    printf("-----------------------------------------------------------------------------------------------------------------\n");
+    for (int n=MIN_N+1; n<=LAYERED_MAX_N; n++) {
+        DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
+        TspInstance I = instance_from_matrix(d);
+        int *tour = malloc(n * sizeof(int));
+        char *seen = calloc(n, 1);
+        size_t full = ((size_t)1 << n) * n * sizeof(long long);
+        size_t layers = 0, with_tour = 0;
+
+        double s = wall_seconds();
+        long long c1 = held_karp_layered(d, NULL, &layers);
+        double t = wall_seconds() - s;
+        long long c2 = held_karp_layered(d, tour, &with_tour);
+        size_t half = 0;
+        s = wall_seconds();
+        long long c3 = held_karp_mitm(d, &half);
+        double tm = wall_seconds() - s;
+        long long ref = n <= SIMD_BENCH_MAX_N ? held_karp_simd(d) : c1;
+
+        int ok = c1 == ref && c2 == ref && c3 == ref && tour_cost(&I, tour) == ref;
+        for (int i=0; i<n && ok; i++) {
+            if (tour[i] < 0 || tour[i] >= n || seen[tour[i]]) ok = 0;
+            else seen[tour[i]] = 1;
         }
-        return;
+        printf("%2d | %11zu | %11zu | %12zu | %13.6f | %11zu | %12.6f | %4lld | %s\n", n, full, layers,
+               with_tour, t, half, tm, c1, ok ? "OK" : "ERREUR");
+        free(seen);
+        free(tour);
+        dm_free(d);
     }
-    /* essayer toutes les villes non utilisées (1..n-1) */
-    for (int v=1; v<n; v++){
-        if (!used_global[v]) {
-            used_global[v] = 1;
-            perm[depth] = v;
-            backtrack_perm(d, n, perm, depth+1);
-            used_global[v] = 0;
+}
+
+#define CONSTRAINED_SIZES {12, 16, 20}
+#define WINDOW_WIDTH MAX_DIST
+#define CONSTRAINED_CHECK_N 9        /* oracle par permutations: n <= 9 (8! ordres) */
+#define CONSTRAINED_CHECK_TRIALS 25  /* instances par n et par sorte de contraintes */
+
+/* Méthode exacte: backtracking (coût porté, symétrie brisée) contre algorithme de Heap,
+ * sur matrices symétriques et asymétriques; les deux doivent donner l'optimum de Held-Karp.
+ */
+void report_exact_variants() {
+    printf("\nMethode exacte: backtracking vs algorithme de Heap\n\n");
+    printf(" n | type | backtrack(s) |  heap(s)  | cout | note\n");
+    printf("------------------------------------------------------\n");
+    for (int n=MAX_EXACT_N-2; n<=MAX_EXACT_N; n++) {
+        for (int asym=0; asym<2; asym++) {
+            DistMatrix *d = asym ? generate_random_asymmetric_graph(&ctx, n, MAX_DIST)
+                                 : generate_random_complete_graph(&ctx, n, MAX_DIST);
+            double s = wall_seconds();
+            long long c1 = tsp_exact(d);
+            double t1 = wall_seconds() - s;
+            s = wall_seconds();
+            long long c2 = tsp_exact_heap(d);
+            double t2 = wall_seconds() - s;
+            printf("%2d | %4s | %12.6f | %9.6f | %4lld | %s\n", n, asym ? "ATSP" : "TSP", t1, t2, c1,
+                   c1 == c2 && c1 == held_karp(d) ? "OK" : "ERREUR");
+            dm_free(d);
         }
     }
 }
 
-/* wrapper pour la méthode exacte */
-long long tsp_exact(long long **d, int n) {
-    /* initialisations */
-    int m = n-1;
-    int *perm = malloc(m * sizeof(int));
-    exact_best_perm = malloc(m * sizeof(int));
-    used_global = calloc(n, sizeof(int)); /* index 0..n-1 */
-    used_global[0] = 1; /* ville 0 fixée comme départ */
-    exact_best_cost = INFLL;
+/* ATSP: tous les solveurs exacts doivent coïncider; borne de l'affectation et écart */
+void report_atsp() {
+    printf("\nATSP (matrices asymetriques, distances 1..%d)\n\n", MAX_DIST);
+    printf(" n | exact_time(s) | heldkarp_time(s) | best_cost | bound(AP) | gap(%%) | note\n");
+    printf("-------------------------------------------------------------------------------\n");
+    for (int n=MIN_N; n<=MAX_N; n++) {
+        DistMatrix *d = generate_random_asymmetric_graph(&ctx, n, MAX_DIST);
+        double te = -1.0;
+        long long ce = -1;
+        if (n <= MAX_EXACT_N) {
+            double s = wall_seconds();
+            ce = tsp_exact(d);
+            te = wall_seconds() - s;
+        }
+        double s = wall_seconds();
+        long long c = held_karp(d);
+        double th = wall_seconds() - s;
+        TspInstance I = instance_from_matrix(d);
+        long long b = tsp_lower_bound(&I, c);
+        int ok = (ce < 0 || ce == c) && held_karp_layered(d, NULL, NULL) == c
+                 && held_karp_simd(d) == c && b <= c;
+        if (te >= 0)
+            printf("%2d |   %10.6f  |   %10.6f    |  %8lld | %9lld | %6.2f | %s\n", n, te, th, c, b,
+                   optimality_gap(c, b), ok ? "OK" : "ERREUR");
+        else
+            printf("%2d |       ---     |   %10.6f    |  %8lld | %9lld | %6.2f | %s\n", n, th, c, b,
+                   optimality_gap(c, b), ok ? "OK" : "ERREUR");
+        dm_free(d);
+    }
+}
 
-    backtrack_perm(d, n, perm, 0);
+/* Oracle de held_karp_constrained: tous les ordres de visite des villes hors de mask, à
+ * partir de la ville last atteinte à l'instant t, avec les mêmes règles (précédences,
+ * attente jusqu'à ready, arrivée <= due, retour <= due[0]). Un ordre est abandonné dès sa
+ * première violation. Renvoie le plus petit instant de retour au dépôt, -1 si aucun.
+ */
+static long long constrained_brute(const DistMatrix *d, const TspConstraints *C, uint32_t mask,
+                                   int last, long long t) {
+    int n = d->n;
+    if (mask == (1u << n) - 1) {
+        long long back = t + dm_get(d, last, 0);
+        return C->due && back > C->due[0] ? -1 : back;
+    }
+    long long best = -1;
+    for (int c=1;c<n;c++) {
+        if (mask & (1u << c)) continue;
+        if (C->before && (C->before[c] & ~mask)) continue;
+        long long a = t + dm_get(d, last, c);
+        if (C->ready && a < C->ready[c]) a = C->ready[c];
+        if (C->due && a > C->due[c]) continue;
+        long long r = constrained_brute(d, C, mask | 1u << c, c, a);
+        if (r >= 0 && (best < 0 || r < best)) best = r;
+    }
+    return best;
+}
 
-    free(perm);
-    free(used_global);
-    free(exact_best_perm);
-    return exact_best_cost;
+/* Contraintes tirées sans tournée de référence, donc souvent irréalisables: précédences
+ * quelconques (cycles possibles), fenêtres au hasard; sort = 0 précédences seules, 1 fenêtres
+ * seules, 2 les deux. Tableaux alloués par malloc (à libérer par free). */
+static TspConstraints random_constraints_any(const DistMatrix *d, int sort) {
+    int n = d->n;
+    TspConstraints C = { NULL, NULL, NULL, NULL };
+    if (sort != 1) {
+        C.before = calloc(n, sizeof(uint32_t));
+        for (int j=1;j<n;j++)
+            for (int i=1;i<n;i++)
+                if (i != j && tsp_rand(&ctx) % (2 * n) == 0) C.before[j] |= 1u << i;
+    }
+    if (sort != 0) {
+        long long horizon = (long long)n * MAX_DIST / 2;
+        C.ready = malloc(n * sizeof(long long));
+        C.due = malloc(n * sizeof(long long));
+        for (int j=0;j<n;j++) {
+            C.ready[j] = j == 0 ? 0 : tsp_rand(&ctx) % (horizon + 1);
+            C.due[j] = C.ready[j] + tsp_rand(&ctx) % (horizon + 1);
+        }
+        C.due[0] = (long long)n * MAX_DIST;
+    }
+    return C;
 }
 
-/* ---------- Held-Karp (DP bitmask) ---------- */
+/* held_karp_constrained contre constrained_brute pour n <= CONSTRAINED_CHECK_N: contraintes
+ * réalisables (generate_random_constraints), contraintes quelconques des trois sortes, et
+ * contraintes vides (qui doivent aussi donner held_karp). Renvoie le nombre d'écarts. */
+static int check_constrained(int *instances) {
+    int errors = 0;
+    *instances = 0;
+    for (int n=2; n<=CONSTRAINED_CHECK_N; n++)
+        for (int t=0; t<CONSTRAINED_CHECK_TRIALS; t++)
+            for (int kind=0; kind<5; kind++) {
+                DistMatrix *d = generate_random_asymmetric_graph(&ctx, n, MAX_DIST);
+                TspConstraints C = { NULL, NULL, NULL, NULL };
+                if (kind == 0) C = generate_random_constraints(&ctx, d, n / 2, tsp_rand(&ctx) % (WINDOW_WIDTH + 1));
+                else if (kind <= 3) C = random_constraints_any(d, kind - 1);
+                long long got = held_karp_constrained(d, &C, NULL);
+                long long want = constrained_brute(d, &C, 1u, 0, 0);
+                /* contraintes générées: réalisables; contraintes vides: coût de held_karp */
+                int ok = got == want && !(kind == 0 && want < 0) && !(kind == 4 && got != held_karp(d));
+                (*instances)++;
+                if (!ok && errors++ < 10)
+                    printf("ERREUR: n=%d, contraintes %d: held_karp_constrained %lld, force brute %lld\n",
+                           n, kind, got, want);
+                if (kind == 0) free_constraints(&C);
+                else {
+                    free(C.before);
+                    free(C.ready);
+                    free(C.due);
+                }
+                dm_free(d);
+            }
+    return errors;
+}
 
-/* Held-Karp: dp[mask][j] = coût minimal pour partir de 0, visiter l'ensemble 'mask' (qui contient 0),
- * et finir en j (j dans mask). mask est représenté par entiers 0..(1<<n)-1.
- *
- * On n'inclut jamais la ville 0 dans la partie "liste des finis" explicitement: ici on conserve 0 dans mask 
- * pour simplicité.
- *
- * Complexité: O(n^2 * 2^n) en temps et O(n * 2^n) en mémoire.
+/* ATSP avec fenêtres de temps (largeur WINDOW_WIDTH) et n/2 précédences: DP restreinte
+ * aux états atteignables contre la DP complète sans contraintes, après la vérification contre
+ * la force brute (check_constrained). Renvoie 2 en cas d'écart.
  */
+int report_constrained() {
+    int instances, errors = check_constrained(&instances);
+    printf("\nHeld-Karp sous contraintes contre la force brute (n <= %d): %d instances, %d ecarts\n",
+           CONSTRAINED_CHECK_N, instances, errors);
+    int sizes[] = CONSTRAINED_SIZES;
+    printf("\nATSP avec fenetres de temps (+-%d) et precedences: etats atteignables seulement\n\n", WINDOW_WIDTH);
+    printf(" n | etats_complets | etats_crees | dp_complete(s) | dp_contrainte(s) | makespan\n");
+    printf("--------------------------------------------------------------------------------\n");
+    for (int i=0; i<(int)(sizeof(sizes)/sizeof(sizes[0])); i++) {
+        int n = sizes[i];
+        DistMatrix *d = generate_random_asymmetric_graph(&ctx, n, MAX_DIST);
+        TspConstraints C = generate_random_constraints(&ctx, d, n / 2, WINDOW_WIDTH);
+        if (!C.due) { dm_free(d); continue; }
+        size_t full = ((size_t)1 << (n-1)) * (n-1), states = 0;
+        double s = wall_seconds();
+        held_karp(d);
+        double tf = wall_seconds() - s;
+        s = wall_seconds();
+        long long mk = held_karp_constrained(d, &C, &states);
+        double tc = wall_seconds() - s;
+        printf("%2d | %14zu | %11zu | %14.6f | %16.6f | %lld\n", n, full, states, tf, tc, mk);
+        free_constraints(&C);
+        dm_free(d);
+    }
+    return errors ? 2 : 0;
+}
+
+/* ---------- Résolution d'un fichier TSPLIB ---------- */
+
+#define TSPLIB_HK_MAX_N 20       /* Held-Karp: 2^20 x 20 entrées (~170 Mo) */
+#define TSPLIB_BOUND_MAX_N 5000  /* borne du 1-arbre: O(n^2) par itération */
+
+static void tsplib_report(const char *method, long long cost, double secs, long long opt, int exact) {
+    printf(" %-16s | %10lld | %9.4f | ", method, cost, secs);
+    if (opt < 0) printf("%s\n", exact ? "exact" : "-");
+    else if (exact) printf("%s\n", cost == opt ? "optimum OK" : "ERREUR (optimum attendu)");
+    else printf("%+.2f%% / optimum\n", 100.0 * (double)(cost - opt) / (double)opt);
+}
+
+/* Lance tous les solveurs applicables sur un fichier TSPLIB et compare à l'optimum connu
+ * (opt < 0: recherché dans tsplib_optima). Renvoie 0 si tout est cohérent, 2 sinon.
+ */
+int solve_tsplib_file(const char *path, long long opt) {
+    TsplibProblem P;
+    if (tsplib_read(NULL, path, &P) != 0) return 1;
+    TspInstance *I = &P.inst;
+    int n = I->n;
+    if (opt < 0) opt = tsplib_known_optimum(P.name);
+    int status = 0;
+
+    printf("Instance %s: n=%d, %s", P.name, n, P.asymmetric ? "ATSP" : "TSP");
+    if (opt >= 0) printf(", optimum connu %lld", opt);
+    printf("\n\n %-16s | %10s | %9s | verification\n", "methode", "cout", "temps(s)");
+    printf("--------------------------------------------------------------\n");
 
-long long held_karp(long long **d, int n) {
-    int Nmask = 1<<n;
-    /* dp: tableau (Nmask) x n */
-    long long *dp = malloc((size_t)Nmask * n * sizeof(long long));
-    if (!dp) {
-        fprintf(stderr, "Memoire insuffisante pour dp (n=%d)\n", n);
-        exit(1);
-    }
-    /* indexation: dp[mask * n + j] */
-    for (int mask=0; mask<Nmask; mask++){
-        for (int j=0;j<n;j++) dp[mask*n + j] = INFLL;
-    }
-
-    /* Initialisation: pour tout j != 0, C({0,j}, j) = d(0,j) -> mask with bits 0 and j set */
-    for (int j=1;j<n;j++){
-        int mask = (1<<0) | (1<<j);
-        dp[mask*n + j] = d[0][j];
-    }
-
-    /* Itérer sur les tailles croissantes de sous-ensembles */
-    for (int mask=0; mask<Nmask; mask++){
-        /* si mask ne contient pas 0, on l'ignore */
-        if (!(mask & 1)) continue;
-        /* pour chaque j tel que j est dans mask et j != 0 */
-        for (int j=1;j<n;j++){
-            if (!(mask & (1<<j))) continue;
-            long long cur = dp[mask*n + j];
-            if (cur == INFLL) continue;
-            /* on essaie d'étendre le chemin en ajoutant une ville k non encore dans mask */
-            for (int k=1;k<n;k++){
-                if (mask & (1<<k)) continue;
-                int nmask = mask | (1<<k);
-                long long cand = cur + d[j][k];
-                long long *slot = &dp[nmask*n + k];
-                if (cand < *slot) *slot = cand;
+    if (n <= TSPLIB_HK_MAX_N) {
+        DistMatrix *owned = I->d ? NULL : instance_to_matrix(I);
+        const DistMatrix *d = I->d ? I->d : owned;
+        if (n <= MAX_EXACT_N) {
+            double s = wall_seconds();
+            long long c = tsp_exact(d);
+            tsplib_report("exact", c, wall_seconds() - s, opt, 1);
+            if (opt >= 0 && c != opt) status = 2;
+        }
+        double s = wall_seconds();
+        long long c = held_karp(d);
+        tsplib_report("held_karp", c, wall_seconds() - s, opt, 1);
+        if (opt >= 0 && c != opt) status = 2;
+        if (opt < 0) opt = c;
+        dm_free(owned);
+    }
+
+    if (P.asymmetric) {
+        double s = wall_seconds();
+        long long b = assignment_bound(I->d);
+        double dt = wall_seconds() - s;
+        printf(" %-16s | %10lld | %9.4f | ", "borne affect.", b, dt);
+        if (opt >= 0 && b > opt) { printf("ERREUR (borne > optimum)\n"); status = 2; }
+        else printf("%s\n", opt >= 0 ? "<= optimum" : "-");
+        printf(" (heuristiques 2-opt/LK: instances symetriques uniquement)\n");
+    } else {
+        if (n <= TSPLIB_BOUND_MAX_N) {
+            double s = wall_seconds();
+            long long b = one_tree_bound(I, opt);
+            double dt = wall_seconds() - s;
+            printf(" %-16s | %10lld | %9.4f | ", "borne 1-arbre", b, dt);
+            if (opt >= 0 && b > opt) { printf("ERREUR (borne > optimum)\n"); status = 2; }
+            else printf("%s\n", opt >= 0 ? "<= optimum" : "-");
+        }
+        int *tour = malloc(n * sizeof(int));
+        double s = wall_seconds();
+        long long c = tsp_local_search(I, tour);
+        tsplib_report("2-opt/Or-opt", c, wall_seconds() - s, opt, 0);
+        free(tour);
+
+        s = wall_seconds();
+        LkResult R = tsp_lin_kernighan(I, LK_TIME_BUDGET, LK_THREADS, SEED);
+        tsplib_report("lin_kernighan", R.cost, wall_seconds() - s, opt, 0);
+        if (opt >= 0 && R.cost < opt) status = 2;
+        free_lk_result(&R);
+    }
+
+    tsplib_free(&P);
+    return status;
+}
+
+/* ---------- Mode service: flux d'instances, pool de threads ---------- */
+
+/* ./tsp_compare --serve [socket]
+ * Lit une suite d'instances sur l'entrée standard (ou, avec un chemin, sur chaque connexion
+ * d'une socket locale AF_UNIX) et renvoie une ligne par instance, dans l'ordre de fin de calcul:
+ *     id nom n methode cout latence_ms
+ * Deux formats d'enregistrement, mélangeables dans un même flux:
+ *   - texte TSPLIB, terminé par la ligne EOF (échéance SERVE_DEADLINE_MS);
+ *   - binaire: un octet SERVE_MAGIC, uint32 n, uint32 échéance (ms), puis n*n uint32
+ *     (matrice ligne par ligne, ordre d'octets de la machine).
+ * Solveur choisi selon n et le temps restant avant l'échéance: énumération si n <= SERVE_EXACT_N,
+ * Held-Karp si son temps estimé tient dans l'échéance, sinon Lin-Kernighan jusqu'à l'échéance
+ * (plus proche voisin pour un ATSP). Chaque connexion a son thread de lecture; toutes
+ * alimentent la même file, servie par un pool de threads qui vit pendant tout le service;
+ * Held-Karp utilise la version spécialisée jusqu'à n = HK_FIXED_MAX_N, au-delà chaque thread
+ * garde son tableau dp d'une instance à l'autre: plus de démarrage ni d'allocation par instance.
+ */
+
+#define SERVE_MAGIC 0xB5
+#define SERVE_THREADS LK_THREADS
+#define SERVE_QUEUE 64
+#define SERVE_DEADLINE_MS 1000
+#define SERVE_EXACT_N 8
+#define SERVE_HK_MAX_N 22
+#define SERVE_HK_NS_PER_OP 2.0      /* coût mesuré d'une relaxation de held_karp (ns) */
+#define SERVE_MIN_LK_BUDGET 0.001   /* en deçà, 2-opt / Or-opt seul */
+#define SERVE_BIN_MAX_N 10000
+
+/* Une connexion (ou l'entrée standard): ses résultats et ses instances en cours */
+typedef struct {
+    FILE *out;
+    int pending;
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+} ServeConn;
+
+typedef struct {
+    long long id;
+    TsplibProblem P;
+    double deadline;      /* secondes après réception */
+    double arrival;       /* wall_seconds() à la réception */
+    ServeConn *conn;
+} ServeJob;
+
+typedef struct {
+    ServeJob *q[SERVE_QUEUE];
+    int head, count, closed;
+    int clients;          /* connexions en cours (un thread serve_client chacune) */
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty, not_full, no_client;
+} ServeQueue;
+
+typedef struct {
+    ServeQueue *Q;
+    long long *dp;        /* tableau Held-Karp réutilisé d'une instance à l'autre */
+    size_t dp_cap;        /* en entrées */
+} ServeWorker;
+
+static void serve_reply(ServeConn *C, long long id, const char *name, int n,
+                        const char *method, long long cost, double latency) {
+    pthread_mutex_lock(&C->lock);
+    fprintf(C->out, "%lld %s %d %s %lld %.3f\n", id, name, n, method, cost, 1000.0 * latency);
+    fflush(C->out);
+    pthread_mutex_unlock(&C->lock);
+}
+
+static long long serve_solve(ServeWorker *W, ServeJob *J, const char **method) {
+    TspInstance *I = &J->P.inst;
+    int n = I->n;
+    double left = J->deadline - (wall_seconds() - J->arrival);
+    double hk_est = SERVE_HK_NS_PER_OP * 1e-9 * ldexp(1.0, n) * n * n;
+
+    if (n <= SERVE_EXACT_N || (n <= SERVE_HK_MAX_N && hk_est <= left)) {
+        DistMatrix *owned = I->d ? NULL : instance_to_matrix(I);
+        const DistMatrix *d = I->d ? I->d : owned;
+        long long c;
+        if (n <= SERVE_EXACT_N) {
+            *method = "exact";
+            c = tsp_exact(d);
+        } else if (n <= HK_FIXED_MAX_N) {
+            *method = "held_karp";
+            c = held_karp_fixed(d);      /* version spécialisée, dp sur la pile si n <= 12 */
+        } else {
+            size_t need = ((size_t)1 << n) * n;
+            if (need > W->dp_cap) {
+                free(W->dp);
+                W->dp = malloc(need * sizeof(long long));
+                W->dp_cap = W->dp ? need : 0;
             }
+            *method = "held_karp";
+            c = W->dp ? held_karp_dp(d, W->dp) : held_karp_layered(d, NULL, NULL);
         }
+        dm_free(owned);
+        return c;
     }
+    if (J->P.asymmetric || (I->d && !dm_is_symmetric(I->d))) {
+        *method = "plus_proche_voisin";
+        return nearest_neighbor_cost(I);
+    }
+    left = J->deadline - (wall_seconds() - J->arrival);
+    if (left < SERVE_MIN_LK_BUDGET) {
+        int *tour = malloc(n * sizeof(int));
+        long long c = tsp_local_search(I, tour);
+        free(tour);
+        *method = "2-opt/Or-opt";
+        return c;
+    }
+    /* le pool occupe déjà les cœurs: un seul thread LK par instance */
+    LkResult R = tsp_lin_kernighan(I, left, 1, SEED + (unsigned)J->id);
+    long long c = R.cost;
+    free_lk_result(&R);
+    *method = "lin_kernighan";
+    return c;
+}
+
+static void *serve_worker(void *arg) {
+    ServeWorker *W = arg;
+    ServeQueue *Q = W->Q;
+    for (;;) {
+        pthread_mutex_lock(&Q->lock);
+        while (Q->count == 0 && !Q->closed) pthread_cond_wait(&Q->not_empty, &Q->lock);
+        if (Q->count == 0) { pthread_mutex_unlock(&Q->lock); break; }
+        ServeJob *J = Q->q[Q->head];
+        Q->head = (Q->head + 1) % SERVE_QUEUE;
+        Q->count--;
+        pthread_cond_signal(&Q->not_full);
+        pthread_mutex_unlock(&Q->lock);
+
+        const char *method = "";
+        long long c = serve_solve(W, J, &method);
+        ServeConn *C = J->conn;
+        serve_reply(C, J->id, J->P.name, J->P.inst.n, method, c, wall_seconds() - J->arrival);
+        tsplib_free(&J->P);
+        free(J);
 
-    /* solution finale: min_{j!=0} dp[(1<<n)-1][j] + d[j][0] */
-    int full = (1<<n) - 1;
-    long long best = INFLL;
-    for (int j=1;j<n;j++){
-        long long val = dp[full*n + j];
-        if (val == INFLL) continue;
-        long long total = val + d[j][0];
-        if (total < best) best = total;
+        pthread_mutex_lock(&C->lock);
+        if (--C->pending == 0) pthread_cond_signal(&C->done);
+        pthread_mutex_unlock(&C->lock);
     }
-    free(dp);
-    return best;
+    return NULL;
 }
 
-/* ---------- Mesure de temps et comparaisons ---------- */
+/* Lit l'enregistrement suivant. Renvoie 1 si une instance est lue, 0 en fin de flux, -1 si erreur. */
+static int serve_read_job(FILE *in, ServeJob *J) {
+    int c;
+    while ((c = getc(in)) == ' ' || c == '\t' || c == '\n' || c == '\r') ;
+    if (c == EOF) return 0;
+    memset(&J->P, 0, sizeof(J->P));
+    J->deadline = SERVE_DEADLINE_MS / 1000.0;
+
+    if (c == SERVE_MAGIC) {
+        uint32_t hdr[2];
+        if (fread(hdr, sizeof(uint32_t), 2, in) != 2 || hdr[0] == 0 || hdr[0] > SERVE_BIN_MAX_N) return -1;
+        int n = (int)hdr[0];
+        uint32_t *row = malloc(n * sizeof(uint32_t));
+        DistMatrix *d = dm_alloc(NULL, n, UINT32_MAX);
+        if (!row || !d) {
+            free(row);
+            dm_free(d);
+            return -1;
+        }
+        for (int i=0;i<n;i++) {
+            if (fread(row, sizeof(uint32_t), n, in) != (size_t)n) {
+                free(row);
+                dm_free(d);
+                return -1;
+            }
+            for (int j=0;j<n;j++) dm_set(d, i, j, i == j ? 0 : row[j]);
+        }
+        free(row);
+        J->P.matrix = dm_narrow(d);
+        J->P.inst = instance_from_matrix(J->P.matrix);
+        J->P.asymmetric = !dm_is_symmetric(J->P.matrix);
+        snprintf(J->P.name, sizeof(J->P.name), "binaire");
+        J->deadline = hdr[1] / 1000.0;
+    } else {
+        ungetc(c, in);
+        if (tsplib_read_stream(NULL, in, "flux", &J->P) != 0) return -1;
+    }
+    J->arrival = wall_seconds();
+    return 1;
+}
+
+/* Distribue les instances d'un flux au pool; revient quand toutes ont reçu leur réponse */
+static void serve_stream(ServeQueue *Q, FILE *in, FILE *out) {
+    ServeConn C;
+    C.out = out;
+    C.pending = 0;
+    pthread_mutex_init(&C.lock, NULL);
+    pthread_cond_init(&C.done, NULL);
+    fprintf(out, "# id nom n methode cout latence_ms\n");
+    fflush(out);
+
+    for (long long id=0;; id++) {
+        ServeJob *J = malloc(sizeof(ServeJob));
+        if (!J) {
+            serve_reply(&C, id, "-", 0, "erreur", -1, 0.0);
+            break;
+        }
+        int r = serve_read_job(in, J);
+        if (r == 0) { free(J); break; }
+        if (r < 0) {
+            free(J);
+            serve_reply(&C, id, "-", 0, "erreur", -1, 0.0);
+            if (feof(in) || ferror(in)) break;
+            continue;
+        }
+        J->id = id;
+        J->conn = &C;
+        pthread_mutex_lock(&C.lock);
+        C.pending++;
+        pthread_mutex_unlock(&C.lock);
+
+        pthread_mutex_lock(&Q->lock);
+        while (Q->count == SERVE_QUEUE) pthread_cond_wait(&Q->not_full, &Q->lock);
+        Q->q[(Q->head + Q->count) % SERVE_QUEUE] = J;
+        Q->count++;
+        pthread_cond_signal(&Q->not_empty);
+        pthread_mutex_unlock(&Q->lock);
+    }
 
-double time_seconds_clock(clock_t start, clock_t end) {
-    return (double)(end - start) / CLOCKS_PER_SEC;
+    pthread_mutex_lock(&C.lock);
+    while (C.pending > 0) pthread_cond_wait(&C.done, &C.lock);
+    pthread_mutex_unlock(&C.lock);
+    pthread_mutex_destroy(&C.lock);
+    pthread_cond_destroy(&C.done);
 }
 
-int main() {
-    srand(SEED);
+#ifndef _WIN32
+typedef struct {
+    ServeQueue *Q;
+    int fd;
+} ServeClient;
+
+/* Thread d'une connexion: ses instances rejoignent la file commune, les autres clients
+ * ne sont pas bloqués pendant qu'elle attend ses réponses */
+static void *serve_client(void *arg) {
+    ServeClient *K = arg;
+    ServeQueue *Q = K->Q;
+    int fd2 = dup(K->fd);
+    FILE *in = fdopen(K->fd, "rb");
+    FILE *out = fd2 >= 0 ? fdopen(fd2, "w") : NULL;
+    if (in && out) serve_stream(Q, in, out);
+    if (in) fclose(in); else close(K->fd);
+    if (out) fclose(out); else if (fd2 >= 0) close(fd2);
+    free(K);
+
+    pthread_mutex_lock(&Q->lock);
+    if (--Q->clients == 0) pthread_cond_signal(&Q->no_client);
+    pthread_mutex_unlock(&Q->lock);
+    return NULL;
+}
+#endif
+
+/* Mode service: entrée/sortie standard (socket_path NULL) ou socket locale */
+int tsp_serve(const char *socket_path, int nthreads) {
+    ServeQueue Q;
+    memset(&Q, 0, sizeof(Q));
+    pthread_mutex_init(&Q.lock, NULL);
+    pthread_cond_init(&Q.not_empty, NULL);
+    pthread_cond_init(&Q.not_full, NULL);
+    pthread_cond_init(&Q.no_client, NULL);
+
+    pthread_t *th = malloc(nthreads * sizeof(pthread_t));
+    ServeWorker *W = calloc(nthreads, sizeof(ServeWorker));
+    int started = 0;
+    if (th && W)
+        for (; started<nthreads; started++) {
+            W[started].Q = &Q;
+            if (pthread_create(&th[started], NULL, serve_worker, &W[started]) != 0) break;
+        }
+    if (started == 0) {
+        fprintf(stderr, "tsp_serve: impossible de demarrer le pool de threads\n");
+        free(th);
+        free(W);
+        pthread_mutex_destroy(&Q.lock);
+        pthread_cond_destroy(&Q.not_empty);
+        pthread_cond_destroy(&Q.not_full);
+        pthread_cond_destroy(&Q.no_client);
+        return 1;
+    }
+    nthreads = started;
+
+    int status = 0;
+    if (!socket_path) {
+        serve_stream(&Q, stdin, stdout);
+    } else {
+#ifdef _WIN32
+        fprintf(stderr, "Socket locale non disponible sous Windows: utiliser l'entree standard\n");
+        status = 1;
+#else
+        int s = socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", socket_path);
+        unlink(socket_path);
+        if (s < 0 || bind(s, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s, 8) != 0) {
+            perror(socket_path);
+            status = 1;
+        } else {
+            fprintf(stderr, "En ecoute sur %s (%d threads)\n", socket_path, nthreads);
+            for (;;) {
+                int c = accept(s, NULL, NULL);
+                if (c < 0) {
+                    if (errno == EINTR) continue;
+                    break;
+                }
+                ServeClient *K = malloc(sizeof(ServeClient));
+                pthread_t client;
+                pthread_attr_t attr;
+                pthread_attr_init(&attr);
+                pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+                pthread_mutex_lock(&Q.lock);
+                Q.clients++;
+                pthread_mutex_unlock(&Q.lock);
+                if (K) {
+                    K->Q = &Q;
+                    K->fd = c;
+                }
+                if (!K || pthread_create(&client, &attr, serve_client, K) != 0) {
+                    fprintf(stderr, "tsp_serve: connexion refusee (memoire ou threads)\n");
+                    free(K);
+                    close(c);
+                    pthread_mutex_lock(&Q.lock);
+                    Q.clients--;
+                    pthread_mutex_unlock(&Q.lock);
+                }
+                pthread_attr_destroy(&attr);
+            }
+            /* les connexions encore ouvertes terminent avant la fermeture de la file */
+            pthread_mutex_lock(&Q.lock);
+            while (Q.clients > 0) pthread_cond_wait(&Q.no_client, &Q.lock);
+            pthread_mutex_unlock(&Q.lock);
+            unlink(socket_path);
+        }
+        if (s >= 0) close(s);
+#endif
+    }
+
+    pthread_mutex_lock(&Q.lock);
+    Q.closed = 1;
+    pthread_cond_broadcast(&Q.not_empty);
+    pthread_mutex_unlock(&Q.lock);
+    for (int t=0;t<nthreads;t++) {
+        pthread_join(th[t], NULL);
+        free(W[t].dp);
+    }
+    free(th);
+    free(W);
+    pthread_mutex_destroy(&Q.lock);
+    pthread_cond_destroy(&Q.not_empty);
+    pthread_cond_destroy(&Q.not_full);
+    pthread_cond_destroy(&Q.no_client);
+    return status;
+}
+
+/* Tournée rendue par LK: permutation des n villes dont le coût est bien R->cost */
+static int lk_tour_valid(const TspInstance *I, const LkResult *R) {
+    if (!R->tour) return 0;
+    char *seen = calloc(I->n, 1);
+    if (!seen) return 0;
+    int ok = 1;
+    for (int i=0; i<I->n && ok; i++) {
+        int v = R->tour[i];
+        if (v < 0 || v >= I->n || seen[v]) ok = 0;
+        else seen[v] = 1;
+    }
+    free(seen);
+    return ok && tour_cost(I, R->tour) == R->cost;
+}
+
+int main(int argc, char **argv) {
+    /* ./tsp_compare --bench-simd : Held-Karp scalaire vs vectorisé pour n = 16..24 */
+    if (argc >= 2 && strcmp(argv[1], "--bench-simd") == 0) {
+        tsp_context_init(&ctx, SEED);
+        bench_held_karp_simd();
+        return 0;
+    }
+    /* ./tsp_compare --bench-fixed : Held-Karp générique vs spécialisé pour n = 4..16 */
+    if (argc >= 2 && strcmp(argv[1], "--bench-fixed") == 0) {
+        tsp_context_init(&ctx, SEED);
+        bench_held_karp_fixed();
+        return 0;
+    }
+    /* ./tsp_compare --bench [reference.csv] : banc d'essai, export CSV/JSON */
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) {
+        tsp_context_init(&ctx, SEED);
+        return run_benchmark_suite(argc >= 3 ? argv[2] : NULL);
+    }
+    /* ./tsp_compare --hk-ooc n [dossier] : Held-Karp par couches sur disque */
+    if (argc >= 3 && strcmp(argv[1], "--hk-ooc") == 0)
+        return bench_held_karp_ooc(atoi(argv[2]), argc >= 4 ? argv[3] : HK_OOC_DIR);
+    /* ./tsp_compare --serve [socket] : flux d'instances, résultats au fil de l'eau */
+    if (argc >= 2 && strcmp(argv[1], "--serve") == 0)
+        return tsp_serve(argc >= 3 ? argv[2] : NULL, SERVE_THREADS);
+    /* ./tsp_compare fichier.tsp [optimum] : résolution d'une instance TSPLIB */
+    if (argc >= 2) return solve_tsplib_file(argv[1], argc >= 3 ? atoll(argv[2]) : -1);
+
+    tsp_context_init(&ctx, SEED);
 
     printf("TSP: comparaison Exact (permutations) vs Held-Karp (DP bitmask)\n");
     printf("Instance: graph complet, distances entieres 1..%d (diagonale 0)\n", MAX_DIST);
-    printf("Repetitions par instance: %d\n\n", TRIALS);
+    printf("Instances par n: %d; temps = mediane du banc d'essai (IC 95%% <= %.0f%%)\n\n",
+           TRIALS, 100.0 * BENCH_CI_REL);
 
-    printf(" n | exact_time(s) | heldkarp_time(s) | best_cost | note\n");
-    printf("--------------------------------------------------------------\n");
+    printf(" n | exact_time(s) | heldkarp_time(s) | best_cost |   bound  | gap(%%) | heur_time(s) | heur_cost | note\n");
+    printf("-------------------------------------------------------------------------------------------------------------\n");
 
     for (int n=MIN_N; n<=MAX_N; n++) {
-        double sum_exact = 0.0;
-        double sum_hk = 0.0;
+        double t_exact[TRIALS], t_hk[TRIALS], t_ls[TRIALS];
         long long last_cost = -1;
-        int ran_exact = 1;
-        if (n > MAX_EXACT_N) ran_exact = 0;
+        long long last_ls = -1;
+        long long last_bound = -1;
+        int ran_exact = n <= MAX_EXACT_N;
+        int agree = 1;
 
         for (int t=0;t<TRIALS;t++){
-            long long **d = generate_random_complete_graph(n);
+            DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
             /* Exact */
+            BenchStat E = { 0 };
             if (ran_exact) {
-                clock_t s = clock();
-                long long cost_exact = tsp_exact(d, n);
-                clock_t e = clock();
-                double dt = time_seconds_clock(s,e);
-                sum_exact += dt;
-                last_cost = cost_exact;
+                E = bench_measure("exact", tsp_exact, d);
+                t_exact[t] = E.median;
             }
 
             /* Held-Karp */
-            clock_t s2 = clock();
-            long long cost_hk = held_karp(d, n);
-            clock_t e2 = clock();
-            double dt2 = time_seconds_clock(s2,e2);
-            sum_hk += dt2;
-            last_cost = cost_hk; /* store to display */
-
-            free_matrix_int(d, n);
+            BenchStat H = bench_measure("held_karp", held_karp, d);
+            t_hk[t] = H.median;
+            last_cost = H.cost; /* store to display */
+            if (ran_exact && E.cost != H.cost) agree = 0;
+            if (held_karp_fixed(d) != H.cost || held_karp_simd(d) != H.cost) agree = 0;
+
+            TspInstance I = instance_from_matrix(d);
+
+            /* Borne du 1-arbre (pas de Polyak guidé par l'optimum connu) */
+            last_bound = one_tree_bound(&I, H.cost);
+            if (last_bound > H.cost) agree = 0;
+
+            /* Heuristique plus proche voisin + 2-opt / Or-opt */
+            BenchStat L = bench_measure("2opt_oropt", bench_local_search, d);
+            t_ls[t] = L.median;
+            last_ls = L.cost;
+            if (L.cost < H.cost) agree = 0;
+
+            dm_free(d);
         } /* trials */
 
-        double avg_exact = ran_exact ? (sum_exact / TRIALS) : -1.0;
-        double avg_hk = (sum_hk / TRIALS);
+        double med_exact = ran_exact ? median_of(t_exact, TRIALS) : -1.0;
+        double med_hk = median_of(t_hk, TRIALS);
+        double med_ls = median_of(t_ls, TRIALS);
+        double gap = optimality_gap(last_cost, last_bound);
+        const char *note = !agree ? "DESACCORD" : ran_exact ? "exact OK" : "exact skipped";
         if (ran_exact)
-            printf("%2d |   %10.6f  |   %10.6f    |  %8lld | exact OK\n", n, avg_exact, avg_hk, last_cost);
+            printf("%2d |   %10.6f  |   %10.6f    |  %8lld | %8lld | %6.2f |  %10.6f  |  %8lld | %s\n", n, med_exact, med_hk, last_cost, last_bound, gap, med_ls, last_ls, note);
         else
-            printf("%2d |       ---     |   %10.6f    |  %8lld | exact skipped\n", n, avg_hk, last_cost);
+            printf("%2d |       ---     |   %10.6f    |  %8lld | %8lld | %6.2f |  %10.6f  |  %8lld | %s\n", n, med_hk, last_cost, last_bound, gap, med_ls, last_ls, note);
     }
 
-    return 0;
+    report_exact_variants();
+    report_held_karp_layers();
+    report_atsp();
+    int status = report_constrained();
+
+    /* Grandes instances: seule l'heuristique est applicable */
+    int large[] = LARGE_SIZES;
+    int nlarge = sizeof(large) / sizeof(large[0]);
+    printf("\nGrandes instances euclidiennes (coordonnees 0..%.0f, k=%d voisins)\n\n", MAX_COORD, NEIGHBOR_K);
+    printf("      n | nn_cost      | heur_cost    | gain(%%) | heur_time(s)\n");
+    printf("-----------------------------------------------------------------\n");
+    for (int li=0; li<nlarge; li++) {
+        int n = large[li];
+        TspInstance I = generate_random_euclidean_instance(&ctx, n);
+        int *tour = malloc(n * sizeof(int));
+        int *neigh;
+
+        double s = wall_seconds();
+        neigh = build_neighbor_lists(&I, NEIGHBOR_K);
+        nearest_neighbor_tour(&I, neigh, NEIGHBOR_K, tour);
+        long long nn_cost = tour_cost(&I, tour);
+        local_search_2opt_oropt(&I, tour, neigh, NEIGHBOR_K);
+        long long ls_cost = tour_cost(&I, tour);
+        double t = wall_seconds() - s;
+
+        printf("%7d | %12lld | %12lld | %7.2f | %10.3f\n", n, nn_cost, ls_cost,
+               100.0 * (double)(nn_cost - ls_cost) / (double)nn_cost, t);
+        tsp_free(I.alloc, neigh);
+        free(tour);
+        free_instance_coords(&I);
+    }
+
+    /* Lin-Kernighan itéré: validation contre l'optimum de Held-Karp (sous-optimal = information) */
+    printf("\nLin-Kernighan itere (profondeur %d, %d threads)\n\n", LK_MAX_DEPTH, LK_THREADS);
+    printf(" n | heldkarp | lin_kernighan | note\n");
+    printf("--------------------------------------\n");
+    for (int n=MIN_N; n<=MAX_N; n++) {
+        DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
+        TspInstance I = instance_from_matrix(d);
+        long long cost_hk = held_karp(d);
+        LkResult R = tsp_lin_kernighan(&I, LK_VALIDATE_BUDGET, LK_THREADS, SEED + n);
+        const char *note = R.cost == cost_hk ? "optimal" : "sous-optimal";
+        if (!lk_tour_valid(&I, &R)) { note = "ERREUR (tournee invalide)"; status = 2; }
+        else if (R.cost < cost_hk) { note = "ERREUR (cout < optimum)"; status = 2; }
+        printf("%2d | %8lld | %13lld | %s\n", n, cost_hk, R.cost, note);
+        free_lk_result(&R);
+        dm_free(d);
+    }
+
+    /* Grande instance: meilleure tournée sous échéance + chronologie */
+    {
+        int n = LK_LARGE_N;
+        TspInstance I = generate_random_euclidean_instance(&ctx, n);
+        int *tour = malloc(n * sizeof(int));
+        long long ls_cost = tsp_local_search(&I, tour);
+        LkResult R = tsp_lin_kernighan(&I, LK_TIME_BUDGET, LK_THREADS, SEED);
+        printf("\nn=%d, budget %.1fs: 2-opt/Or-opt %lld -> LK %lld (%.2f%%), %lld perturbations\n",
+               n, LK_TIME_BUDGET, ls_cost, R.cost,
+               100.0 * (double)(ls_cost - R.cost) / (double)ls_cost, R.kicks);
+        printf("   temps(s) |    meilleur | thread\n");
+        int step = R.ntimeline / 10 + 1;
+        for (int i=0; i<R.ntimeline; i++) {
+            if (i % step && i != R.ntimeline - 1) continue;
+            printf("   %8.3f | %11lld | %d\n", R.timeline[i].time, R.timeline[i].cost, R.timeline[i].thread);
+        }
+        free_lk_result(&R);
+        free(tour);
+        free_instance_coords(&I);
+    }
+
+    return status;
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 /* tsp_compare_conio.c
- * Compilation: gcc -O2 -std=c99 tsp_compare_conio.c -o tsp_compare_conio -lm
+ * Compilation: make tsp_compare_conio   (MinGW; solveurs de la bibliothèque tsp.h)
  *
  * Usage: ./tsp_compare_conio
  *
@@ -12,8 +12,7 @@
 #include <limits.h>
 #include <string.h>
 #include "conio2.h"
-
-#define INFLL LLONG_MAX/4
+#include "tsp.h"
 
 /* Paramètres */
 #define SEED 123456
@@ -31,133 +30,6 @@
 #define COLOR_WARNING LIGHTRED
 #define COLOR_BORDER LIGHTBLUE
 
-/* ---------- Utilitaires ---------- */
-
-long long **alloc_matrix_int(int n) {
-    long long **m = malloc(n * sizeof(long long*));
-    for (int i=0;i<n;i++){
-        m[i] = malloc(n * sizeof(long long));
-    }
-    return m;
-}
-
-void free_matrix_int(long long **m, int n){
-    for (int i=0;i<n;i++) free(m[i]);
-    free(m);
-}
-
-long long **generate_random_complete_graph(int n) {
-    long long **d = alloc_matrix_int(n);
-    for (int i=0;i<n;i++){
-        for (int j=0;j<n;j++){
-            if (i==j) d[i][j]=0;
-            else if (j<i) d[i][j]=d[j][i];
-            else d[i][j] = 1 + rand()%MAX_DIST;
-        }
-    }
-    return d;
-}
-
-long long cycle_cost_from_perm(long long **d, int n, int *perm, int m) {
-    long long cost = 0;
-    int prev = 0;
-    for (int i=0;i<m;i++) {
-        int cur = perm[i];
-        cost += d[prev][cur];
-        prev = cur;
-    }
-    cost += d[prev][0];
-    return cost;
-}
-
-/* ---------- Méthode exacte ---------- */
-
-long long exact_best_cost;
-int *exact_best_perm;
-int *used_global;
-
-void backtrack_perm(long long **d, int n, int *perm, int depth) {
-    if (depth == n-1) {
-        long long cost = cycle_cost_from_perm(d, n, perm, n-1);
-        if (cost < exact_best_cost) {
-            exact_best_cost = cost;
-            for (int i=0;i<n-1;i++) exact_best_perm[i] = perm[i];
-        }
-        return;
-    }
-    for (int v=1; v<n; v++){
-        if (!used_global[v]) {
-            used_global[v] = 1;
-            perm[depth] = v;
-            backtrack_perm(d, n, perm, depth+1);
-            used_global[v] = 0;
-        }
-    }
-}
-
-long long tsp_exact(long long **d, int n) {
-    int m = n-1;
-    int *perm = malloc(m * sizeof(int));
-    exact_best_perm = malloc(m * sizeof(int));
-    used_global = calloc(n, sizeof(int));
-    used_global[0] = 1;
-    exact_best_cost = INFLL;
-
-    backtrack_perm(d, n, perm, 0);
-
-    free(perm);
-    free(used_global);
-    free(exact_best_perm);
-    return exact_best_cost;
-}
-
-/* ---------- Held-Karp ---------- */
-
-long long held_karp(long long **d, int n) {
-    int Nmask = 1<<n;
-    long long *dp = malloc((size_t)Nmask * n * sizeof(long long));
-    if (!dp) {
-        fprintf(stderr, "Memoire insuffisante pour dp (n=%d)\n", n);
-        exit(1);
-    }
-    
-    for (int mask=0; mask<Nmask; mask++){
-        for (int j=0;j<n;j++) dp[mask*n + j] = INFLL;
-    }
-
-    for (int j=1;j<n;j++){
-        int mask = (1<<0) | (1<<j);
-        dp[mask*n + j] = d[0][j];
-    }
-
-    for (int mask=0; mask<Nmask; mask++){
-        if (!(mask & 1)) continue;
-        for (int j=1;j<n;j++){
-            if (!(mask & (1<<j))) continue;
-            long long cur = dp[mask*n + j];
-            if (cur == INFLL) continue;
-            for (int k=1;k<n;k++){
-                if (mask & (1<<k)) continue;
-                int nmask = mask | (1<<k);
-                long long cand = cur + d[j][k];
-                long long *slot = &dp[nmask*n + k];
-                if (cand < *slot) *slot = cand;
-            }
-        }
-    }
-
-    int full = (1<<n) - 1;
-    long long best = INFLL;
-    for (int j=1;j<n;j++){
-        long long val = dp[full*n + j];
-        if (val == INFLL) continue;
-        long long total = val + d[j][0];
-        if (total < best) best = total;
-    }
-    free(dp);
-    return best;
-}
-
 /* ---------- Fonctions Conio2 ---------- */
 
 void draw_box(int x1, int y1, int x2, int y2, int color) {
@@ -277,7 +149,8 @@ double time_seconds_clock(clock_t start, clock_t end) {
 /* ---------- Main ---------- */
 
 int main() {
-    srand(SEED);
+    TspContext ctx;
+    tsp_context_init(&ctx, SEED);
     
     display_title();
     
@@ -296,11 +169,11 @@ int main() {
         for (int t=0; t<TRIALS; t++){
             display_progress(n, t+1, TRIALS, progress_y);
             
-            long long **d = generate_random_complete_graph(n);
+            DistMatrix *d = generate_random_complete_graph(&ctx, n, MAX_DIST);
             
             if (ran_exact) {
                 clock_t s = clock();
-                long long cost_exact = tsp_exact(d, n);
+                long long cost_exact = tsp_exact(d);
                 clock_t e = clock();
                 double dt = time_seconds_clock(s, e);
                 sum_exact += dt;
@@ -308,13 +181,13 @@ int main() {
             }
 
             clock_t s2 = clock();
-            long long cost_hk = held_karp(d, n);
+            long long cost_hk = held_karp(d);
             clock_t e2 = clock();
             double dt2 = time_seconds_clock(s2, e2);
             sum_hk += dt2;
             last_cost = cost_hk;
 
-            free_matrix_int(d, n);
+            dm_free(d);
         }
 
         double avg_exact = ran_exact ? (sum_exact / TRIALS) : -1.0;
@@ -0,0 +1,2570 @@
+/* tsp.c
+ * Moteur de la bibliothèque TSP (interface: tsp.h). Compilation: make
+ *
+ * Aucune variable globale modifiable: les tables constantes sont en lecture seule, la table
+ * des coefficients binomiaux est remplie une seule fois (pthread_once). Toute la mémoire
+ * passe par l'allocateur de l'objet traité, le hasard par le TspContext de l'appelant.
+ */
+
+#define _POSIX_C_SOURCE 200809L   /* clock_gettime, posix_memalign */
+#define TSP_BUILD
+#include "tsp.h"
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/* ---------- Allocation et contexte ---------- */
+
+#define CACHE_LINE 64
+
+static void *default_alloc(void *user, size_t bytes, size_t align) {
+    (void)user;
+#ifdef _WIN32
+    return _aligned_malloc(bytes, align);
+#else
+    if (align <= 2 * sizeof(void *)) return malloc(bytes);
+    void *p = NULL;
+    if (posix_memalign(&p, align, bytes) != 0) return NULL;
+    return p;
+#endif
+}
+
+static void default_release(void *user, void *p) {
+    (void)user;
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static const TspAllocator default_allocator = { default_alloc, default_release, NULL };
+
+/* Bloc aligné sur align; un bloc vide reste distinct de NULL (échec) */
+static void *tsp_alloc_align(const TspAllocator *A, size_t bytes, size_t align) {
+    if (!A) A = &default_allocator;
+    return A->alloc(A->user, bytes > 0 ? bytes : 1, align);
+}
+
+void *tsp_alloc(const TspAllocator *A, size_t bytes) {
+    return tsp_alloc_align(A, bytes, 2 * sizeof(void *));
+}
+
+/* Aligné sur une ligne de cache (matrices, tables des DP vectorisées) */
+static void *tsp_alloc_aligned(const TspAllocator *A, size_t bytes) {
+    return tsp_alloc_align(A, bytes, CACHE_LINE);
+}
+
+static void *tsp_calloc(const TspAllocator *A, size_t count, size_t size) {
+    void *p = tsp_alloc(A, count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+void tsp_free(const TspAllocator *A, void *p) {
+    if (!p) return;
+    if (!A) A = &default_allocator;
+    A->release(A->user, p);
+}
+
+static unsigned xorshift32(unsigned *s) {
+    unsigned x = *s;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *s = x;
+}
+
+void tsp_context_init(TspContext *ctx, unsigned seed) {
+    ctx->alloc = default_allocator;
+    ctx->rng = seed ? seed : 1;
+}
+
+unsigned tsp_rand(TspContext *ctx) {
+    return xorshift32(&ctx->rng);
+}
+
+/* ---------- Matrice de distances contiguë ---------- */
+
+/* Une seule allocation alignée sur une ligne de cache (au lieu de n lignes dispersées),
+ * éléments du type entier le plus étroit qui contient la plus grande distance
+ * (uint8_t pour des distances <= 255). Chaque ligne est complétée à un multiple de 64 octets.
+ * Une copie transposée optionnelle (colonnes contiguës) sert aux DP en mode "pull".
+ */
+
+/* Largeur (octets) du plus petit type entier contenant toutes les valeurs de [0, max_value] */
+static int dm_width_for(long long max_value) {
+    if (max_value >= 0 && max_value <= UINT8_MAX) return 1;
+    if (max_value >= 0 && max_value <= UINT16_MAX) return 2;
+    if (max_value >= 0 && max_value <= UINT32_MAX) return 4;
+    return 8;
+}
+
+/* Matrice n x n initialisée à 0, dont les valeurs seront dans [0, max_value].
+ * NULL si mémoire insuffisante.
+ */
+DistMatrix *dm_alloc(const TspAllocator *A, int n, long long max_value) {
+    DistMatrix *M = tsp_alloc(A, sizeof(DistMatrix));
+    if (!M) return NULL;
+    M->n = n;
+    M->alloc = A;
+    M->width = dm_width_for(max_value);
+    int per_line = CACHE_LINE / M->width;
+    M->stride = (n + per_line - 1) / per_line * per_line;
+    size_t bytes = (size_t)n * M->stride * M->width;
+    M->data = tsp_alloc_aligned(A, bytes);
+    if (!M->data) {
+        tsp_free(A, M);
+        return NULL;
+    }
+    memset(M->data, 0, bytes);
+    M->data_t = NULL;
+    return M;
+}
+
+void dm_free(DistMatrix *M) {
+    if (!M) return;
+    tsp_free(M->alloc, M->data);
+    tsp_free(M->alloc, M->data_t);
+    tsp_free(M->alloc, M);
+}
+
+/* Copie transposée de M (colonne k contiguë en k*stride, complétée par 0), allouée par
+ * tsp_alloc_aligned; NULL si mémoire insuffisante. La libérer avec tsp_free(M->alloc, .).
+ */
+static void *dm_transpose_copy(const DistMatrix *M) {
+    size_t bytes = (size_t)M->n * M->stride * M->width;
+    void *t = tsp_alloc_aligned(M->alloc, bytes);
+    if (!t) return NULL;
+    memset(t, 0, bytes);
+    for (int i=0;i<M->n;i++)
+        for (int j=0;j<M->n;j++)
+            dm_store(t, M->width, (size_t)j * M->stride + i, dm_get(M, i, j));
+    return t;
+}
+
+/* Construit (une fois) la copie transposée: colonne k contiguë en data_t + k*stride.
+ * Les écritures suivantes par dm_set mettent à jour les deux copies.
+ * Renvoie 0 si succès, -1 si mémoire insuffisante.
+ */
+int dm_build_transpose(DistMatrix *M) {
+    if (M->data_t) return 0;
+    M->data_t = dm_transpose_copy(M);
+    return M->data_t ? 0 : -1;
+}
+
+/* Réduit la matrice au type le plus étroit possible (après une lecture en 64 bits).
+ * La matrice d'origine est gardée si la copie ne peut pas être allouée.
+ */
+DistMatrix *dm_narrow(DistMatrix *M) {
+    long long maxv = 0, minv = 0;
+    for (int i=0;i<M->n;i++)
+        for (int j=0;j<M->n;j++) {
+            long long v = dm_get(M, i, j);
+            if (v > maxv) maxv = v;
+            if (v < minv) minv = v;
+        }
+    if (minv < 0 || dm_width_for(maxv) == M->width) return M;
+    DistMatrix *R = dm_alloc(M->alloc, M->n, maxv);
+    if (!R) return M;
+    for (int i=0;i<M->n;i++)
+        for (int j=0;j<M->n;j++) dm_set(R, i, j, dm_get(M, i, j));
+    dm_free(M);
+    return R;
+}
+
+/* Vrai si d(i,j) = d(j,i) pour tout couple (TSP), faux sinon (ATSP) */
+int dm_is_symmetric(const DistMatrix *M) {
+    for (int i=0;i<M->n;i++)
+        for (int j=0;j<i;j++) if (dm_get(M, i, j) != dm_get(M, j, i)) return 0;
+    return 1;
+}
+
+/* ---------- utilitaires ---------- */
+
+/* Génère une matrice de distances symétrique avec diagonale 0 */
+DistMatrix *generate_random_complete_graph(TspContext *ctx, int n, long long max_dist) {
+    DistMatrix *d = dm_alloc(&ctx->alloc, n, max_dist);
+    if (!d) return NULL;
+    for (int i=0;i<n;i++){
+        for (int j=0;j<n;j++){
+            if (i==j) dm_set(d, i, j, 0);
+            else if (j<i) dm_set(d, i, j, dm_get(d, j, i));
+            else dm_set(d, i, j, 1 + tsp_rand(ctx) % max_dist);
+        }
+    }
+    return d;
+}
+
+/* Génère une matrice asymétrique (ATSP): d(i,j) et d(j,i) tirés indépendamment */
+DistMatrix *generate_random_asymmetric_graph(TspContext *ctx, int n, long long max_dist) {
+    DistMatrix *d = dm_alloc(&ctx->alloc, n, max_dist);
+    if (!d) return NULL;
+    for (int i=0;i<n;i++)
+        for (int j=0;j<n;j++) dm_set(d, i, j, i == j ? 0 : 1 + tsp_rand(ctx) % max_dist);
+    return d;
+}
+
+/* Calcule le coût d'un cycle: 0 -> perm[0] -> perm[1] -> ... -> perm[m-1] -> 0
+ * Ici perm contient les villes visitées après 0 (par ex. {1,3,2,4}).
+ */
+long long cycle_cost_from_perm(const DistMatrix *d, int *perm, int m) {
+    long long cost = 0;
+    int prev = 0;
+    for (int i=0;i<m;i++) {
+        int cur = perm[i];
+        cost += dm_get(d, prev, cur);
+        prev = cur;
+    }
+    cost += dm_get(d, prev, 0); /* retour à 0 */
+    return cost;
+}
+
+/* ---------- Instances: matrice complète ou coordonnées ---------- */
+
+/* Une instance est soit une matrice de distances (d != NULL), soit des coordonnées dont les
+ * distances sont calculées à la volée selon les règles TSPLIB, sans matrice n x n.
+ */
+
+#define GEO_RRR 6378.388   /* rayon terrestre TSPLIB (km) */
+
+static long long geo_dist(const TspInstance *I, int i, int j) {
+    double q1 = cos(I->y[i] - I->y[j]);
+    double q2 = cos(I->x[i] - I->x[j]);
+    double q3 = cos(I->x[i] + I->x[j]);
+    return (long long)(GEO_RRR * acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+}
+
+/* Distance entre deux villes (arrondis TSPLIB: EUC_2D = entier le plus proche) */
+static inline long long inst_dist(const TspInstance *I, int i, int j) {
+    if (I->d) return dm_get(I->d, i, j);
+    if (i == j) return 0;
+    double dx = I->x[i] - I->x[j], dy = I->y[i] - I->y[j];
+    switch (I->type) {
+    case TSP_CEIL_2D:
+        return (long long)ceil(sqrt(dx*dx + dy*dy));
+    case TSP_ATT: {
+        double r = sqrt((dx*dx + dy*dy) / 10.0);
+        long long t = (long long)(r + 0.5);
+        return t < r ? t + 1 : t;
+    }
+    case TSP_GEO:
+        return geo_dist(I, i, j);
+    default:
+        return (long long)(sqrt(dx*dx + dy*dy) + 0.5);
+    }
+}
+
+/* Vrai si les distances sont planes (grille de voisinage utilisable). Renvoie dans *scale
+ * un facteur tel que distance >= scale * distance_euclidienne(coordonnées) - 1.
+ */
+static int inst_planar(const TspInstance *I, double *scale) {
+    if (I->d || I->type == TSP_GEO) return 0;
+    *scale = (I->type == TSP_ATT) ? 1.0 / sqrt(10.0) : 1.0;
+    return 1;
+}
+
+TspInstance instance_from_matrix(const DistMatrix *d) {
+    TspInstance I = { d->n, d, NULL, NULL, TSP_EUC_2D, d->alloc };
+    return I;
+}
+
+/* Matrice complète (nouvelle allocation) d'une instance à coordonnées, pour les petits n.
+ * NULL si mémoire insuffisante.
+ */
+DistMatrix *instance_to_matrix(const TspInstance *I) {
+    DistMatrix *d = dm_alloc(I->alloc, I->n, LLONG_MAX);
+    if (!d) return NULL;
+    for (int i=0;i<I->n;i++)
+        for (int j=0;j<I->n;j++) dm_set(d, i, j, inst_dist(I, i, j));
+    return dm_narrow(d);
+}
+
+/* Coût de la tournée du plus proche voisin depuis la ville 0 (borne supérieure rapide, O(n^2)) */
+long long nearest_neighbor_cost(const TspInstance *I) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    char *seen = tsp_calloc(A, n, 1);
+    long long cost = 0;
+    int cur = 0;
+    seen[0] = 1;
+    for (int step=1; step<n; step++){
+        int nxt = -1;
+        for (int v=0; v<n; v++){
+            if (!seen[v] && (nxt < 0 || inst_dist(I, cur, v) < inst_dist(I, cur, nxt))) nxt = v;
+        }
+        seen[nxt] = 1;
+        cost += inst_dist(I, cur, nxt);
+        cur = nxt;
+    }
+    cost += inst_dist(I, cur, 0);
+    tsp_free(A, seen);
+    return cost;
+}
+
+/* ---------- Méthode exacte: énumération des permutations par backtracking ---------- */
+
+/* État de la recherche exhaustive (un par appel: plusieurs recherches peuvent tourner
+ * en parallèle, cf. mode service) */
+typedef struct {
+    long long best_cost;
+    int *best_perm;
+    int *used;
+    int symmetric;        /* matrice symétrique: un seul sens de parcours est énuméré */
+    int above;            /* villes non placées d'indice > perm[0] */
+} ExactSearch;
+
+/* backtrack_perm:
+ * - perm: tableau courant d'ordre des villes (taille m = depth)
+ * - depth: profondeur actuelle (= nombre de villes déjà placées)
+ * - n: nombre total de villes
+ * - partial: coût du chemin 0 -> perm[0] -> ... -> perm[depth-1], porté par la récursion
+ *   (une feuille ne coûte plus que l'arête de retour, au lieu de O(n))
+ * Si la matrice est symétrique, une tournée et son inverse ont le même coût: on impose
+ * perm[0] < perm[n-2]. Dès qu'il ne reste plus de ville d'indice > perm[0] à placer, la
+ * dernière ville sera forcément plus petite: le sous-arbre est coupé (moitié des feuilles).
+ */
+static void backtrack_perm(const DistMatrix *d, int n, ExactSearch *S, int *perm, int depth, long long partial) {
+    if (depth == n-1) {
+        /* perm est complet : il ne manque que le retour à 0 */
+        long long cost = partial + dm_get(d, depth > 0 ? perm[depth-1] : 0, 0);
+        if (cost < S->best_cost) {
+            S->best_cost = cost;
+            for (int i=0;i<n-1;i++) S->best_perm[i] = perm[i];
+        }
+        return;
+    }
+    if (S->symmetric && depth > 0 && S->above == 0) return;
+    int prev = depth > 0 ? perm[depth-1] : 0;
+    /* essayer toutes les villes non utilisées (1..n-1) */
+    for (int v=1; v<n; v++){
+        if (!S->used[v]) {
+            S->used[v] = 1;
+            perm[depth] = v;
+            if (depth == 0) S->above = n-1 - v;
+            else if (v > perm[0]) S->above--;
+            backtrack_perm(d, n, S, perm, depth+1, partial + dm_get(d, prev, v));
+            if (depth > 0 && v > perm[0]) S->above++;
+            S->used[v] = 0;
+        }
+    }
+}
+
+/* wrapper pour la méthode exacte */
+long long tsp_exact(const DistMatrix *d) {
+    const TspAllocator *A = d->alloc;
+    /* initialisations */
+    int n = d->n;
+    int m = n-1;
+    int *perm = tsp_alloc(A, m * sizeof(int));
+    ExactSearch S;
+    S.best_perm = tsp_alloc(A, m * sizeof(int));
+    S.used = tsp_calloc(A, n, sizeof(int)); /* index 0..n-1 */
+    S.used[0] = 1; /* ville 0 fixée comme départ */
+    S.best_cost = INFLL;
+    S.symmetric = dm_is_symmetric(d);
+    S.above = 0;
+
+    backtrack_perm(d, n, &S, perm, 0, 0);
+
+    tsp_free(A, perm);
+    tsp_free(A, S.used);
+    tsp_free(A, S.best_perm);
+    return S.best_cost;
+}
+
+/* Coût des arêtes touchant les positions a et b (a < b) du cycle 0 -> p[0] -> ... -> p[m-1] -> 0:
+ * la position -1 et la position m désignent la ville 0. Les arêtes communes (b = a+1) ne
+ * sont comptées qu'une fois.
+ */
+static long long swap_edges(const DistMatrix *d, const int *p, int m, int a, int b) {
+#define PCITY(i) ((i) < 0 || (i) >= m ? 0 : p[i])
+    long long c = dm_get(d, PCITY(a-1), p[a]) + dm_get(d, p[a], PCITY(a+1));
+    if (b != a+1) c += dm_get(d, PCITY(b-1), p[b]);
+    c += dm_get(d, p[b], PCITY(b+1));
+#undef PCITY
+    return c;
+}
+
+/* Variante: algorithme de Heap. Chaque permutation suivante s'obtient par un seul échange
+ * de deux positions: le coût est mis à jour en O(1) (au plus 4 arêtes retirées / ajoutées)
+ * au lieu d'être recalculé. Énumère les (n-1)! ordres (sans élagage par symétrie).
+ */
+long long tsp_exact_heap(const DistMatrix *d) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    int m = n-1;
+    if (m <= 0) return 0;
+    int *p = tsp_alloc(A, m * sizeof(int));
+    int *c = tsp_calloc(A, m, sizeof(int));
+    for (int i=0;i<m;i++) p[i] = i+1;
+    long long cost = cycle_cost_from_perm(d, p, m);
+    long long best = cost;
+    int i = 1;
+    while (i < m) {
+        if (c[i] < i) {
+            int a = (i % 2 == 0) ? 0 : c[i];
+            int lo = a < i ? a : i, hi = a < i ? i : a;
+            cost -= swap_edges(d, p, m, lo, hi);
+            int tmp = p[a]; p[a] = p[i]; p[i] = tmp;
+            cost += swap_edges(d, p, m, lo, hi);
+            if (cost < best) best = cost;
+            c[i]++;
+            i = 1;
+        } else {
+            c[i] = 0;
+            i++;
+        }
+    }
+    tsp_free(A, p);
+    tsp_free(A, c);
+    return best;
+}
+
+/* ---------- Held-Karp (DP bitmask) ---------- */
+
+/* Held-Karp: dp[mask][j] = coût minimal pour partir de 0, visiter l'ensemble 'mask' (qui contient 0),
+ * et finir en j (j dans mask). mask est représenté par entiers 0..(1<<n)-1.
+ *
+ * On n'inclut jamais la ville 0 dans la partie "liste des finis" explicitement: ici on conserve 0 dans mask 
+ * pour simplicité.
+ *
+ * Complexité: O(n^2 * 2^n) en temps et O(n * 2^n) en mémoire.
+ */
+
+/* Relaxation depuis (mask, j) vers toutes les villes k hors de mask: la ligne j de la
+ * matrice est lue de façon contiguë avec son type réel T (uint8_t, uint16_t, ...).
+ */
+#define HK_RELAX_ROW(T) { \
+        const T *row = (const T *)d->data + (size_t)j * d->stride; \
+        for (int k=1;k<n;k++){ \
+            if (mask & (1<<k)) continue; \
+            long long cand = cur + row[k]; \
+            long long *slot = &dp[(size_t)(mask | (1<<k))*n + k]; \
+            if (cand < *slot) *slot = cand; \
+        } \
+    }
+
+/* Replis (sections suivantes) si la table dp ne peut pas être allouée: demi-couches en
+ * mémoire (rencontre au milieu), puis couches sur disque */
+long long held_karp_layered(const DistMatrix *d, int *tour, size_t *peak_bytes);
+long long held_karp_mitm(const DistMatrix *d, size_t *peak_bytes);
+long long held_karp_out_of_core(const DistMatrix *d, const char *dir, size_t *peak_disk);
+
+/* Held-Karp dans un tableau dp fourni par l'appelant, d'au moins 2^n * n entrées
+ * (réutilisable d'un appel à l'autre, cf. mode service).
+ */
+long long held_karp_dp(const DistMatrix *d, long long *dp) {
+    int n = d->n;
+    int Nmask = 1<<n;
+    /* indexation: dp[mask * n + j] */
+    for (size_t i=0; i<(size_t)Nmask*n; i++) dp[i] = INFLL;
+
+    /* Initialisation: pour tout j != 0, C({0,j}, j) = d(0,j) -> mask with bits 0 and j set */
+    for (int j=1;j<n;j++){
+        int mask = (1<<0) | (1<<j);
+        dp[(size_t)mask*n + j] = dm_get(d, 0, j);
+    }
+
+    /* Itérer sur les tailles croissantes de sous-ensembles */
+    for (int mask=0; mask<Nmask; mask++){
+        /* si mask ne contient pas 0, on l'ignore */
+        if (!(mask & 1)) continue;
+        /* pour chaque j tel que j est dans mask et j != 0 */
+        for (int j=1;j<n;j++){
+            if (!(mask & (1<<j))) continue;
+            long long cur = dp[(size_t)mask*n + j];
+            if (cur == INFLL) continue;
+            /* on essaie d'étendre le chemin en ajoutant une ville k non encore dans mask */
+            switch (d->width) {
+            case 1: HK_RELAX_ROW(uint8_t) break;
+            case 2: HK_RELAX_ROW(uint16_t) break;
+            case 4: HK_RELAX_ROW(uint32_t) break;
+            default: HK_RELAX_ROW(int64_t) break;
+            }
+        }
+    }
+
+    /* solution finale: min_{j!=0} dp[(1<<n)-1][j] + d[j][0] */
+    int full = (1<<n) - 1;
+    long long best = INFLL;
+    for (int j=1;j<n;j++){
+        long long val = dp[(size_t)full*n + j];
+        if (val == INFLL) continue;
+        long long total = val + dm_get(d, j, 0);
+        if (total < best) best = total;
+    }
+    return best;
+}
+
+long long held_karp(const DistMatrix *d) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    /* dp: tableau (2^n) x n */
+    long long *dp = tsp_alloc(A, ((size_t)1 << n) * n * sizeof(long long));
+    if (!dp) {
+        fprintf(stderr, "Memoire insuffisante pour dp (n=%d): rencontre au milieu\n", n);
+        return held_karp_mitm(d, NULL);
+    }
+    long long best = held_karp_dp(d, dp);
+    tsp_free(A, dp);
+    return best;
+}
+
+/* ---------- Held-Karp par couches (rang combinatoire) ---------- */
+
+/* dp[S][j] ne dépend que des sous-ensembles de cardinal |S|-1: on calcule la DP couche par
+ * couche. La couche k contient, pour chaque sous-ensemble S de {1..n-1} de taille k, les k
+ * valeurs dp[S][j] (j dans S, par ordre croissant), soit C(n-1,k)*k entrées au lieu de 2^n*n.
+ * Adressage: rang colexicographique (système de numération combinatoire)
+ *     rang(S) = somme_i C(e_i, i)   pour e_1 < e_2 < ... < e_k
+ * Les sous-ensembles de taille k sont énumérés par l'astuce de Gosper, dans l'ordre croissant
+ * des entiers, qui est exactement l'ordre colex: la couche k est écrite séquentiellement.
+ * La couche k-1 est lue par rang.
+ */
+
+/* Remplie une seule fois (premier appel, quel que soit le thread), puis en lecture seule */
+static size_t binom_table[HK_MAX_BITS + 1][HK_MAX_BITS + 1];
+static pthread_once_t binom_once = PTHREAD_ONCE_INIT;
+
+static void binom_fill(void) {
+    for (int a=0; a<=HK_MAX_BITS; a++) {
+        binom_table[a][0] = 1;
+        for (int b=1; b<=a; b++)
+            binom_table[a][b] = binom_table[a-1][b-1] + (b <= a-1 ? binom_table[a-1][b] : 0);
+    }
+}
+
+static void binom_init() {
+    pthread_once(&binom_once, binom_fill);
+}
+
+/* C(a, b), 0 si b > a */
+static size_t binom(int a, int b) {
+    return (b < 0 || b > a) ? 0 : binom_table[a][b];
+}
+
+/* Rang colex d'un sous-ensemble (bits = éléments) */
+static size_t colex_rank(uint64_t S) {
+    size_t r = 0;
+    for (int i=1; S; i++, S &= S-1) r += binom(__builtin_ctzll(S), i);
+    return r;
+}
+
+/* Sous-ensemble suivant de même cardinal (Gosper) */
+static inline uint64_t gosper_next(uint64_t S) {
+    uint64_t c = S & (~S + 1);
+    uint64_t r = S + c;
+    return (((r ^ S) >> 2) / c) | r;
+}
+
+/* Ligne de S (|S| = k >= 2, éléments e[0..k-1]) de la couche k, à partir de la couche k-1 */
+static inline void hk_layer_row(const DistMatrix *d, int k, const int *e, const long long *prev,
+                                long long *out, uint8_t *pred) {
+    size_t pre[HK_MAX_BITS + 1], suf[HK_MAX_BITS + 2];
+    /* sommes partielles pour le rang de S \ {e_p} */
+    pre[0] = 0;
+    for (int i=0;i<k;i++) pre[i+1] = pre[i] + binom(e[i], i+1);
+    suf[k] = 0;
+    for (int i=k-1;i>=0;i--) suf[i] = suf[i+1] + binom(e[i], i);
+
+    for (int p=0; p<k; p++) {
+        /* rang(S\{e_p}) = rangs inchangés avant p + éléments après p décalés d'un cran */
+        size_t pr = pre[p] + suf[p+1];
+        const long long *row = prev + pr * (k-1);
+        long long best = INFLL;
+        int arg = 0;
+        for (int q=0, col=0; q<k; q++) {
+            if (q == p) continue;
+            long long v = row[col] + dm_get(d, e[q]+1, e[p]+1);
+            if (v < best) { best = v; arg = col; }
+            col++;
+        }
+        out[p] = best;
+        if (pred) pred[p] = (uint8_t)arg;
+    }
+}
+
+/* Calcule la couche k (k >= 2) à partir de la couche k-1, villes 1..m.
+ * pred (optionnel) reçoit pour chaque entrée la position, dans la ligne de S \ {j},
+ * du prédécesseur retenu: de quoi reconstruire la tournée.
+ */
+static void hk_layer_step(const DistMatrix *d, int m, int k, const long long *prev,
+                          long long *out, uint8_t *pred) {
+    int e[HK_MAX_BITS];
+    size_t count = binom(m, k);
+    uint64_t S = ((uint64_t)1 << k) - 1;
+    for (size_t r=0; r<count; r++, S = gosper_next(S)) {
+        int c = 0;
+        for (uint64_t t=S; t; t &= t-1) e[c++] = __builtin_ctzll(t);
+        hk_layer_row(d, k, e, prev, out + r * k, pred ? pred + r * k : NULL);
+    }
+}
+
+/* Position p de S (p-ième bit à 1, à partir de 0) */
+static int subset_element(uint64_t S, int p) {
+    while (p--) S &= S-1;
+    return __builtin_ctzll(S);
+}
+
+/* Held-Karp par couches en mémoire: seules les couches k-1 et k sont allouées.
+ * tour (optionnel, n villes): tournée optimale, reconstruite à partir de points de contrôle
+ * d'un octet par entrée (prédécesseur de chaque couche), soit 2^(n-2)*(n-1) octets.
+ * peak_bytes (optionnel) reçoit la mémoire maximale utilisée.
+ * Si une couche ne peut pas être allouée, repli sur le calcul hors mémoire (coût seul,
+ * tour[0] = -1).
+ */
+long long held_karp_layered(const DistMatrix *d, int *tour, size_t *peak_bytes) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    if (peak_bytes) *peak_bytes = 0;
+    if (n < 3 || n - 1 > HK_MAX_BITS) {
+        if (tour) for (int i=0;i<n;i++) tour[i] = i;
+        return held_karp(d);
+    }
+    binom_init();
+    int m = n - 1;
+    uint8_t **pred = NULL;
+    size_t pred_bytes = 0, peak = 0;
+    long long *prev = tsp_alloc(A, (size_t)m * sizeof(long long));
+    if (tour) pred = tsp_calloc(A, m + 1, sizeof(uint8_t*));
+    if (!prev || (tour && !pred)) goto oom;
+    for (int j=0;j<m;j++) prev[j] = dm_get(d, 0, j+1);
+
+    for (int k=2; k<=m; k++) {
+        size_t entries = binom(m, k) * k;
+        long long *cur = tsp_alloc(A, entries * sizeof(long long));
+        if (!cur) goto oom;
+        if (pred) {
+            pred[k] = tsp_alloc(A, entries);
+            if (!pred[k]) { tsp_free(A, cur); goto oom; }
+            pred_bytes += entries;
+        }
+        size_t live = (binom(m, k-1) * (k-1) + entries) * sizeof(long long) + pred_bytes;
+        if (live > peak) peak = live;
+        hk_layer_step(d, m, k, prev, cur, pred ? pred[k] : NULL);
+        tsp_free(A, prev);
+        prev = cur;
+    }
+
+    /* Couche m: une seule ligne (S = {1..n-1}) */
+    long long best = INFLL;
+    int p = 0;
+    for (int j=0;j<m;j++) {
+        long long total = prev[j] + dm_get(d, j+1, 0);
+        if (total < best) { best = total; p = j; }
+    }
+    tsp_free(A, prev);
+
+    if (tour) {
+        /* Remontée: à la couche k, la ville en position p de S est visitée en k-ième */
+        uint64_t S = ((uint64_t)1 << m) - 1;
+        tour[0] = 0;
+        for (int k=m; k>=1; k--) {
+            int e = subset_element(S, p);
+            tour[k] = e + 1;
+            if (k > 1) p = pred[k][colex_rank(S) * k + p];
+            S &= ~((uint64_t)1 << e);
+        }
+        for (int k=2; k<=m; k++) tsp_free(A, pred[k]);
+        tsp_free(A, pred);
+    }
+    if (peak_bytes) *peak_bytes = peak;
+    return best;
+
+oom:
+    tsp_free(A, prev);
+    if (pred) {
+        for (int k=2; k<=m; k++) tsp_free(A, pred[k]);
+        tsp_free(A, pred);
+    }
+    fprintf(stderr, "Memoire insuffisante pour les couches (n=%d): calcul sur disque\n", n);
+    if (tour) tour[0] = -1;
+    return held_karp_out_of_core(d, HK_OOC_DIR, peak_bytes);
+}
+
+/* ---------- Held-Karp bidirectionnel (rencontre au milieu) ---------- */
+
+/* Une tournée optimale se coupe en deux chemins: 0 -> (S, |S| = h) -> j, puis j -> k avec k
+ * dans le complément T, et k -> (T) -> 0. On calcule
+ *   - en avant: F[S][j], chemins partant de 0 (couches 1..h);
+ *   - en arrière: B[T][k], chemins de k vers 0 par T (couches 1..m-h): c'est la même DP
+ *     sur la matrice transposée, donc hk_layer_step réutilisé tel quel;
+ * puis on joint: min F[S][j] + d(j,k) + B[T][k] sur S, j dans S, k dans T = complément de S.
+ * Jointure par fusion triée: le complément inverse l'ordre colex parmi les sous-ensembles de
+ * taille fixe, rang(T) = C(m,h) - 1 - rang(S): B est parcouru dans l'ordre, F à rebours.
+ * Seules les couches jusqu'à m/2 sont calculées, et les deux dernières (h et b) ne sont pas
+ * stockées: leurs lignes sont recalculées au moment de la jointure. Pour une matrice
+ * symétrique B = F: une seule demi-DP suffit (deux fois moins de calcul que held_karp_layered).
+ */
+
+/* Couches 1..upto de la DP avant sur d (villes 1..m). Renvoie la couche upto; prev_out
+ * (optionnel) reçoit la couche upto-1, conservée au lieu d'être libérée. *peak est mis à jour
+ * avec held + octets vivants. NULL si mémoire insuffisante.
+ */
+static long long *hk_run_layers(const DistMatrix *d, int m, int upto, long long **prev_out,
+                                size_t held, size_t *peak) {
+    const TspAllocator *A = d->alloc;
+    long long *prev = tsp_alloc(A, (size_t)m * sizeof(long long));
+    if (!prev) return NULL;
+    for (int j=0;j<m;j++) prev[j] = dm_get(d, 0, j+1);
+    if (held + (size_t)m * sizeof(long long) > *peak) *peak = held + (size_t)m * sizeof(long long);
+    if (prev_out) *prev_out = NULL;
+    for (int k=2; k<=upto; k++) {
+        size_t prev_bytes = binom(m, k-1) * (k-1) * sizeof(long long);
+        size_t bytes = binom(m, k) * k * sizeof(long long);
+        long long *cur = tsp_alloc(A, bytes);
+        if (!cur) { tsp_free(A, prev); return NULL; }
+        if (held + prev_bytes + bytes > *peak) *peak = held + prev_bytes + bytes;
+        hk_layer_step(d, m, k, prev, cur, NULL);
+        if (prev_out && k == upto) *prev_out = prev;
+        else tsp_free(A, prev);
+        prev = cur;
+    }
+    return prev;
+}
+
+long long held_karp_mitm(const DistMatrix *d, size_t *peak_bytes) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    if (peak_bytes) *peak_bytes = 0;
+    if (n < 3 || n - 1 > HK_MAX_BITS) return held_karp(d);
+    binom_init();
+    int m = n - 1;
+    int h = m / 2, b = m - h;            /* |S| = h <= |T| = b */
+    size_t count = binom(m, h);          /* = C(m, b) */
+    size_t peak = 0;
+    int sym = dm_is_symmetric(d);
+    const DistMatrix *db = d;            /* matrice de la DP arrière */
+    DistMatrix *dt = NULL;
+    /* Lignes de la couche h (avant) et b (arrière) recalculées à la volée pendant la jointure,
+     * à partir des couches h-1 et b-1: seules ces dernières sont stockées.
+     * Symétrique, b = h+1: la couche h sert à la fois de lignes avant et de couche b-1. */
+    long long *Fstore = NULL, *Fprev = NULL, *Bprev = NULL;
+    int ok = 1;
+
+    if (sym && b == h + 1) {
+        Fstore = Bprev = hk_run_layers(d, m, h, NULL, 0, &peak);
+        ok = Fstore != NULL;
+    } else if (sym) {
+        if (h > 1) ok = (Fprev = Bprev = hk_run_layers(d, m, h-1, NULL, 0, &peak)) != NULL;
+    } else {
+        if (h > 1) ok = (Fprev = hk_run_layers(d, m, h-1, NULL, 0, &peak)) != NULL;
+        if (ok) ok = (dt = dm_alloc(A, n, LLONG_MAX)) != NULL;
+        if (ok) {
+            for (int i=0;i<n;i++)
+                for (int j=0;j<n;j++) dm_set(dt, i, j, dm_get(d, j, i));
+            db = dt;
+            size_t held = h > 1 ? binom(m, h-1) * (h-1) * sizeof(long long) : 0;
+            if (b > 1) ok = (Bprev = hk_run_layers(dt, m, b-1, NULL, held, &peak)) != NULL;
+        }
+    }
+    long long *frow = tsp_alloc(A, (size_t)h * sizeof(long long));
+    long long *brow = tsp_alloc(A, (size_t)b * sizeof(long long));
+    if (!ok || !frow || !brow) {
+        tsp_free(A, Fstore ? Fstore : Fprev);
+        if (!sym) tsp_free(A, Bprev);
+        dm_free(dt);
+        tsp_free(A, frow);
+        tsp_free(A, brow);
+        fprintf(stderr, "Memoire insuffisante pour les demi-couches (n=%d): calcul sur disque\n", n);
+        return held_karp_out_of_core(d, HK_OOC_DIR, peak_bytes);
+    }
+
+    /* Jointure: T parcourt les sous-ensembles de taille b dans l'ordre colex, son complément S
+     * les sous-ensembles de taille h dans l'ordre inverse (rang(S) = C(m,h) - 1 - rang(T)). */
+    int e[HK_MAX_BITS], f[HK_MAX_BITS];
+    uint64_t full = ((uint64_t)1 << m) - 1;
+    uint64_t T = ((uint64_t)1 << b) - 1;
+    long long best = INFLL;
+    for (size_t r=0; r<count; r++, T = gosper_next(T)) {
+        int ce = 0, cf = 0;
+        for (uint64_t t=T; t; t &= t-1) f[cf++] = __builtin_ctzll(t);
+        for (uint64_t t=full & ~T; t; t &= t-1) e[ce++] = __builtin_ctzll(t);
+        const long long *fr = frow;
+        if (Fstore) fr = Fstore + (count - 1 - r) * h;
+        else if (h == 1) frow[0] = dm_get(d, 0, e[0]+1);
+        else hk_layer_row(d, h, e, Fprev, frow, NULL);
+        if (b == 1) brow[0] = dm_get(db, 0, f[0]+1);
+        else hk_layer_row(db, b, f, Bprev, brow, NULL);
+        for (int p=0; p<h; p++)
+            for (int q=0; q<b; q++) {
+                long long v = fr[p] + dm_get(d, e[p]+1, f[q]+1) + brow[q];
+                if (v < best) best = v;
+            }
+    }
+
+    tsp_free(A, Fstore ? Fstore : Fprev);
+    if (!sym) tsp_free(A, Bprev);
+    tsp_free(A, frow);
+    tsp_free(A, brow);
+    dm_free(dt);
+    if (peak_bytes) *peak_bytes = peak;
+    return best;
+}
+
+/* ---------- Held-Karp hors mémoire (couches en flux sur disque) ---------- */
+
+/* Quand même deux couches ne tiennent pas en RAM, chacune devient un fichier sur disque
+ * local, supprimé dès que la couche suivante est terminée. Le calcul lit la couche k-1 une
+ * seule fois, séquentiellement, et écrit la couche k une seule fois, séquentiellement.
+ *
+ * Disposition par extrémité: le fichier de la couche k est fait de m blocs, le bloc c
+ * contenant dp[T + {c}][c] pour les T de taille k-1 sans c, dans l'ordre colex de T.
+ * La valeur dp[T + {c}][c] = min_{j dans T} dp[T][j] + d(j,c) ne dépend que de la ligne de T:
+ * en parcourant les T de taille k-1 dans l'ordre de Gosper,
+ *   - la ligne de T se lit dans les blocs j de T, chacun à la suite du précédent (les T qui
+ *     contiennent j arrivent dans l'ordre colex de T \ {j}, celui dans lequel ils ont été
+ *     écrits);
+ *   - chaque c hors de T ajoute sa valeur à la fin de son bloc.
+ * Soit m flux de lecture et m flux d'écriture séquentiels, chacun avec son tampon de
+ * HK_OOC_BUFFER octets: jamais d'accès aléatoire au disque. Chaque remplissage demande
+ * au système le morceau suivant du même bloc (posix_fadvise WILLNEED) et libère le cache du
+ * morceau consommé (DONTNEED), si bien que le cache de pages sert à la lecture anticipée
+ * plutôt qu'à garder une couche déjà lue.
+ */
+
+typedef struct {
+    char path[512];
+#ifdef _WIN32
+    HANDLE file;
+#else
+    int fd;
+#endif
+} LayerFile;
+
+/* Flux séquentiel sur un bloc d'une couche (valeurs long long) */
+typedef struct {
+    long long *buf;
+    size_t cap, len, pos;    /* capacité, valeurs présentes, prochaine valeur lue */
+    uint64_t next, end;      /* prochaine position dans le fichier (en valeurs), fin du bloc */
+} LayerStream;
+
+/* Crée le fichier de la couche k. run identifie l'appel (adresse d'une variable locale):
+ * plusieurs calculs simultanés du même processus peuvent partager le dossier. 0 si succès.
+ */
+static int layer_open(LayerFile *L, const char *dir, const void *run, int k) {
+    snprintf(L->path, sizeof(L->path), "%s/hk_layer_%d_%p_%d.bin", dir, (int)getpid(), run, k);
+#ifdef _WIN32
+    L->file = CreateFileA(L->path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+                          FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE |
+                          FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    return L->file == INVALID_HANDLE_VALUE ? -1 : 0;
+#else
+    L->fd = open(L->path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    return L->fd < 0 ? -1 : 0;
+#endif
+}
+
+/* Ferme et supprime le fichier */
+static void layer_close(LayerFile *L) {
+#ifdef _WIN32
+    CloseHandle(L->file);         /* FILE_FLAG_DELETE_ON_CLOSE */
+#else
+    close(L->fd);
+    unlink(L->path);
+#endif
+}
+
+/* Lecture (write = 0) ou écriture de count valeurs à la position pos (en valeurs).
+ * 0 si tout est passé. */
+static int layer_io(LayerFile *L, int write, long long *buf, size_t count, uint64_t pos) {
+    char *p = (char *)buf;
+    size_t left = count * sizeof(long long);
+    uint64_t off = pos * sizeof(long long);
+    while (left > 0) {
+        size_t chunk = left < ((size_t)1 << 30) ? left : ((size_t)1 << 30);
+#ifdef _WIN32
+        OVERLAPPED o = { 0 };
+        DWORD done = 0;
+        o.Offset = (DWORD)off;
+        o.OffsetHigh = (DWORD)(off >> 32);
+        BOOL ok = write ? WriteFile(L->file, p, (DWORD)chunk, &done, &o)
+                        : ReadFile(L->file, p, (DWORD)chunk, &done, &o);
+        if (!ok || done == 0) return -1;
+#else
+        ssize_t done = write ? pwrite(L->fd, p, chunk, (off_t)off) : pread(L->fd, p, chunk, (off_t)off);
+        if (done <= 0) return -1;
+#endif
+        p += done;
+        off += done;
+        left -= done;
+    }
+    return 0;
+}
+
+/* Conseils au cache de pages sur count valeurs à partir de pos (sans effet sous Windows) */
+static void layer_advise(LayerFile *L, uint64_t pos, uint64_t count, int advice) {
+#ifndef _WIN32
+    posix_fadvise(L->fd, (off_t)(pos * sizeof(long long)), (off_t)(count * sizeof(long long)), advice);
+#else
+    (void)L; (void)pos; (void)count; (void)advice;
+#endif
+}
+
+#ifdef _WIN32
+#define HK_WILLNEED 0
+#define HK_DONTNEED 0
+#else
+#define HK_WILLNEED POSIX_FADV_WILLNEED
+#define HK_DONTNEED POSIX_FADV_DONTNEED
+#endif
+
+/* Prochaine valeur d'un flux de lecture; -1 dans *err si le disque refuse */
+static inline long long stream_get(LayerFile *L, LayerStream *s, int *err) {
+    if (s->pos == s->len) {
+        uint64_t start = s->next - s->len;
+        if (s->len) layer_advise(L, start, s->len, HK_DONTNEED);
+        s->len = s->end - s->next < s->cap ? (size_t)(s->end - s->next) : s->cap;
+        s->pos = 0;
+        if (s->len == 0 || layer_io(L, 0, s->buf, s->len, s->next) != 0) {
+            *err = -1;
+            s->len = 0;
+            return INFLL;
+        }
+        s->next += s->len;
+        if (s->next < s->end) layer_advise(L, s->next, s->end - s->next < s->cap ? s->end - s->next : s->cap, HK_WILLNEED);
+    }
+    return s->buf[s->pos++];
+}
+
+/* Vide le tampon d'un flux d'écriture */
+static int stream_flush(LayerFile *L, LayerStream *s) {
+    if (s->len == 0) return 0;
+    int r = layer_io(L, 1, s->buf, s->len, s->next);
+    s->next += s->len;
+    s->len = 0;
+    return r;
+}
+
+static inline int stream_put(LayerFile *L, LayerStream *s, long long v) {
+    s->buf[s->len++] = v;
+    return s->len == s->cap ? stream_flush(L, s) : 0;
+}
+
+/* Flux du bloc c de la couche k (blocs de C(m-1, k-1) valeurs) */
+static void stream_start(LayerStream *s, int m, int k, int c) {
+    uint64_t size = binom(m-1, k-1);
+    s->next = (uint64_t)c * size;
+    s->end = s->next + size;
+    s->len = s->pos = 0;
+}
+
+/* Held-Karp hors mémoire: couches sur disque dans 'dir'. Renvoie -1 en cas d'erreur d'E/S
+ * (ou de mémoire pour les tampons). peak_disk (optionnel) reçoit l'occupation disque maximale
+ * (deux couches) en octets.
+ */
+long long held_karp_out_of_core(const DistMatrix *d, const char *dir, size_t *peak_disk) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    if (n < 3) return held_karp(d);
+    if (n - 1 > HK_MAX_BITS) {
+        fprintf(stderr, "held_karp_out_of_core: n=%d trop grand\n", n);
+        return -1;
+    }
+    binom_init();
+    int m = n - 1;                       /* villes 1..n-1 -> bits 0..m-1 */
+    size_t cap = HK_OOC_BUFFER / sizeof(long long), peak = 0;
+    long long best = -1;
+    LayerFile prev, cur;
+    int have_prev = 0, have_cur = 0, err = 0;
+    /* dist[c*m + j] = d(j+1, c+1): la colonne de l'extrémité c est contiguë */
+    long long *dist = tsp_alloc(A, (size_t)m * m * sizeof(long long));
+    long long *bufs = tsp_alloc(A, 2 * (size_t)m * cap * sizeof(long long));
+    LayerStream *in = tsp_alloc(A, 2 * (size_t)m * sizeof(LayerStream)), *out = in ? in + m : NULL;
+    if (!dist || !bufs || !in) {
+        fprintf(stderr, "held_karp_out_of_core: memoire insuffisante pour les tampons\n");
+        goto done;
+    }
+    for (int c=0;c<m;c++)
+        for (int j=0;j<m;j++) dist[(size_t)c * m + j] = dm_get(d, j+1, c+1);
+    for (int c=0;c<m;c++) {
+        in[c].buf = bufs + (size_t)c * cap;
+        out[c].buf = bufs + (size_t)(m + c) * cap;
+        in[c].cap = out[c].cap = cap;
+    }
+
+    /* Couche 1: bloc c = { dp[{c}][c] } */
+    if (layer_open(&prev, dir, &peak, 1) != 0) {
+        fprintf(stderr, "held_karp_out_of_core: impossible de creer %s\n", prev.path);
+        goto done;
+    }
+    have_prev = 1;
+    for (int c=0;c<m && !err;c++) {
+        long long v = dm_get(d, 0, c+1);
+        err = layer_io(&prev, 1, &v, 1, (uint64_t)c);
+    }
+
+    for (int k=2; k<=m && !err; k++) {
+        if (layer_open(&cur, dir, &peak, k) != 0) {
+            fprintf(stderr, "held_karp_out_of_core: impossible de creer %s\n", cur.path);
+            goto done;
+        }
+        have_cur = 1;
+        size_t bytes = (binom(m, k-1) * (k-1) + binom(m, k) * k) * sizeof(long long);
+        if (bytes > peak) peak = bytes;
+        for (int c=0;c<m;c++) {
+            stream_start(&in[c], m, k-1, c);
+            stream_start(&out[c], m, k, c);
+        }
+        int e[HK_MAX_BITS];
+        long long row[HK_MAX_BITS];
+        size_t count = binom(m, k-1);
+        uint64_t T = ((uint64_t)1 << (k-1)) - 1;
+        for (size_t r=0; r<count && !err; r++, T = gosper_next(T)) {
+            int t = 0;
+            for (uint64_t x=T; x; x &= x-1) {
+                e[t] = __builtin_ctzll(x);
+                row[t] = stream_get(&prev, &in[e[t]], &err);
+                t++;
+            }
+            for (int c=0;c<m && !err;c++) {
+                if (T >> c & 1) continue;
+                const long long *col = dist + (size_t)c * m;
+                long long v = INFLL;
+                for (int q=0;q<t;q++) {
+                    long long w = row[q] + col[e[q]];
+                    if (w < v) v = w;
+                }
+                err = stream_put(&cur, &out[c], v);
+            }
+        }
+        for (int c=0;c<m && !err;c++) err = stream_flush(&cur, &out[c]);
+        layer_close(&prev);
+        prev = cur;
+        have_cur = 0;
+    }
+    if (err) {
+        fprintf(stderr, "held_karp_out_of_core: erreur d'E/S sur %s\n", prev.path);
+        goto done;
+    }
+
+    /* Couche m: bloc c = { dp[{1..n-1}][c] } */
+    best = INFLL;
+    for (int c=0;c<m;c++) {
+        long long v;
+        if (layer_io(&prev, 0, &v, 1, (uint64_t)c) != 0) { best = -1; break; }
+        if (v + dm_get(d, c+1, 0) < best) best = v + dm_get(d, c+1, 0);
+    }
+    if (peak_disk) *peak_disk = peak;
+
+done:
+    if (have_cur) layer_close(&cur);
+    if (have_prev) layer_close(&prev);
+    tsp_free(A, dist);
+    tsp_free(A, bufs);
+    tsp_free(A, in);
+    return best;
+}
+
+/* ---------- Held-Karp sous contraintes (précédences, fenêtres de temps) ---------- */
+
+/* Problème de tournées à sens unique avec contraintes: les distances sont des temps de
+ * trajet (éventuellement asymétriques), départ du dépôt 0 à t = 0.
+ * - précédence: la ville j ne peut être visitée qu'après toutes les villes de before[j];
+ * - fenêtre de temps: arrivée en j à max(ready[j], t + d(i,j)), qui doit être <= due[j]
+ *   (attente autorisée si l'on arrive avant ready[j]).
+ * Objectif: instant de retour au dépôt (makespan), <= due[0] si des fenêtres sont données.
+ * Pour ce critère, arriver plus tôt n'est jamais pire: dp[S][j] = instant d'arrivée au plus
+ * tôt reste exact. Sans fenêtres, le makespan est le coût de la tournée.
+ * Seuls les états (S, j) atteignables sont créés: la DP avance couche par couche dans des
+ * tables de hachage, un état irréalisable n'est jamais alloué ni étendu.
+ */
+
+typedef struct {
+    uint64_t key;         /* (S << 5) | j, 0 = case vide (S contient toujours le dépôt) */
+    long long t;
+} StateEntry;
+
+typedef struct {
+    StateEntry *slot;
+    size_t cap, count;
+    const TspAllocator *alloc;
+} StateMap;
+
+static int sm_init(StateMap *M, const TspAllocator *A, size_t cap) {
+    M->alloc = A;
+    M->cap = 16;
+    while (M->cap < cap) M->cap <<= 1;
+    M->count = 0;
+    M->slot = tsp_calloc(A, M->cap, sizeof(StateEntry));
+    return M->slot ? 0 : -1;
+}
+
+static inline size_t sm_hash(uint64_t key, size_t cap) {
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(key ^ (key >> 32)) & (cap - 1);
+}
+
+/* Insère l'état ou garde le minimum. Renvoie -1 si la table ne peut pas grandir. */
+static int sm_relax(StateMap *M, uint64_t key, long long t) {
+    if (2 * (M->count + 1) > M->cap) {
+        StateMap G;
+        if (sm_init(&G, M->alloc, M->cap * 2) != 0) return -1;
+        for (size_t i=0;i<M->cap;i++)
+            if (M->slot[i].key) {
+                size_t h = sm_hash(M->slot[i].key, G.cap);
+                while (G.slot[h].key) h = (h + 1) & (G.cap - 1);
+                G.slot[h] = M->slot[i];
+            }
+        G.count = M->count;
+        tsp_free(M->alloc, M->slot);
+        *M = G;
+    }
+    size_t h = sm_hash(key, M->cap);
+    while (M->slot[h].key && M->slot[h].key != key) h = (h + 1) & (M->cap - 1);
+    if (!M->slot[h].key) {
+        M->slot[h].key = key;
+        M->slot[h].t = t;
+        M->count++;
+    } else if (t < M->slot[h].t) {
+        M->slot[h].t = t;
+    }
+    return 0;
+}
+
+/* Makespan optimal sous contraintes, HKC_INFEASIBLE si aucune tournée n'est réalisable,
+ * HKC_NOMEM si la mémoire manque, HKC_TOO_LARGE si n > CONSTRAINED_MAX_N.
+ * states (optionnel) reçoit le nombre d'états (S, j) créés, à comparer à 2^(n-1)*(n-1).
+ */
+long long held_karp_constrained(const DistMatrix *d, const TspConstraints *C, size_t *states) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    size_t created = 0;
+    if (states) *states = 0;
+    if (n > CONSTRAINED_MAX_N) {
+        fprintf(stderr, "held_karp_constrained: n=%d > %d\n", n, CONSTRAINED_MAX_N);
+        return HKC_TOO_LARGE;
+    }
+    if (n == 1) return 0;
+
+    StateMap cur, next;
+    if (sm_init(&cur, A, 2 * n) != 0) return HKC_NOMEM;
+    for (int j=1;j<n;j++) {
+        if (C->before && (C->before[j] & ~1u)) continue;
+        long long t = dm_get(d, 0, j);
+        if (C->ready && t < C->ready[j]) t = C->ready[j];
+        if (C->due && t > C->due[j]) continue;
+        if (sm_relax(&cur, ((uint64_t)(1u | 1u << j) << 5) | j, t) != 0) { tsp_free(A, cur.slot); return HKC_NOMEM; }
+    }
+    created += cur.count;
+
+    for (int k=2; k<n; k++) {
+        if (sm_init(&next, A, 2 * cur.count) != 0) { tsp_free(A, cur.slot); return HKC_NOMEM; }
+        for (size_t s=0; s<cur.cap; s++) {
+            if (!cur.slot[s].key) continue;
+            uint32_t mask = (uint32_t)(cur.slot[s].key >> 5);
+            int i = (int)(cur.slot[s].key & 31);
+            for (int c=1;c<n;c++) {
+                if (mask & (1u << c)) continue;
+                if (C->before && (C->before[c] & ~mask)) continue;
+                long long t = cur.slot[s].t + dm_get(d, i, c);
+                if (C->ready && t < C->ready[c]) t = C->ready[c];
+                if (C->due && t > C->due[c]) continue;
+                if (sm_relax(&next, ((uint64_t)(mask | 1u << c) << 5) | c, t) != 0) {
+                    tsp_free(A, cur.slot);
+                    tsp_free(A, next.slot);
+                    return HKC_NOMEM;
+                }
+            }
+        }
+        tsp_free(A, cur.slot);
+        cur = next;
+        created += cur.count;
+    }
+
+    long long best = INFLL;
+    for (size_t s=0; s<cur.cap; s++) {
+        if (!cur.slot[s].key) continue;
+        long long t = cur.slot[s].t + dm_get(d, (int)(cur.slot[s].key & 31), 0);
+        if (C->due && t > C->due[0]) continue;
+        if (t < best) best = t;
+    }
+    tsp_free(A, cur.slot);
+    if (states) *states = created;
+    return best == INFLL ? HKC_INFEASIBLE : best;
+}
+
+/* Contraintes aléatoires construites autour d'une tournée aléatoire (donc réalisables):
+ * fenêtres [a_j - width, a_j + width] autour des instants d'arrivée a_j de cette tournée,
+ * et nprec précédences compatibles avec son ordre de visite.
+ * Contraintes vides (tous les tableaux à NULL) si n n'est pas dans [1, CONSTRAINED_MAX_N]
+ * (before[] est un masque 32 bits) ou si la mémoire manque.
+ */
+TspConstraints generate_random_constraints(TspContext *ctx, const DistMatrix *d, int nprec,
+                                           long long width) {
+    const TspAllocator *A = &ctx->alloc;
+    int n = d->n;
+    TspConstraints C = { NULL, NULL, NULL, A };
+    if (n < 1 || n > CONSTRAINED_MAX_N) {
+        fprintf(stderr, "generate_random_constraints: n=%d hors de [1, %d]\n", n, CONSTRAINED_MAX_N);
+        return C;
+    }
+    C.before = tsp_calloc(A, n, sizeof(uint32_t));
+    C.ready = tsp_alloc(A, n * sizeof(long long));
+    C.due = tsp_alloc(A, n * sizeof(long long));
+    int *perm = tsp_alloc(A, n * sizeof(int));
+    if (!C.before || !C.ready || !C.due || !perm) {
+        tsp_free(A, perm);
+        free_constraints(&C);
+        C.before = NULL; C.ready = NULL; C.due = NULL;
+        return C;
+    }
+    for (int i=0;i<n;i++) perm[i] = i;
+    for (int i=n-1;i>1;i--) {
+        int j = 1 + tsp_rand(ctx) % i;
+        int tmp = perm[i]; perm[i] = perm[j]; perm[j] = tmp;
+    }
+    long long t = 0;
+    for (int i=1;i<=n;i++) {
+        int v = perm[i % n];
+        t += dm_get(d, perm[i-1], v);
+        C.ready[v] = t > width ? t - width : 0;
+        C.due[v] = t + width;
+    }
+    C.ready[0] = 0;
+    for (int p=0; p<nprec && n > 2; p++) {
+        int a = 1 + tsp_rand(ctx) % (n-1);
+        int b = 1 + tsp_rand(ctx) % (n-1);
+        if (a == b) continue;
+        if (a > b) { int tmp = a; a = b; b = tmp; }
+        C.before[perm[b]] |= 1u << perm[a];
+    }
+    tsp_free(A, perm);
+    return C;
+}
+
+void free_constraints(TspConstraints *C) {
+    tsp_free(C->alloc, C->before);
+    tsp_free(C->alloc, C->ready);
+    tsp_free(C->alloc, C->due);
+}
+
+/* ---------- Borne inférieure: 1-arbre + relaxation lagrangienne ---------- */
+
+/* Un 1-arbre = arbre couvrant minimal sur les villes 1..n-1, plus les deux arêtes
+ * les moins chères incidentes à la ville 0. Toute tournée est un 1-arbre où chaque
+ * sommet est de degré 2, donc le coût du 1-arbre minimal minore le coût optimal.
+ *
+ * Relaxation lagrangienne (Held & Karp 1970-71): on pénalise chaque ville i par pi[i],
+ * le coût d'une arête devient d[i][j] + pi[i] + pi[j]. Pour tout pi:
+ *     L(pi) = coût_1arbre(pi) - 2 * somme(pi)  <=  coût optimal.
+ * On maximise L(pi) par montée de sous-gradient: g[i] = degre[i] - 2.
+ *
+ * Chaque itération = un Prim dense en O(n^2), sans tas (adapté aux matrices pleines).
+ */
+
+#define BOUND_MAX_ITER 300   /* itérations de sous-gradient max */
+
+/* Calcule un 1-arbre minimal pour les pénalités pi. Remplit deg[] et renvoie le coût
+ * (avec pénalités). key/parent/in_tree sont des tableaux de travail de taille n.
+ */
+static double one_tree_cost(const TspInstance *I, const double *pi, int *deg,
+                           double *key, int *parent, char *in_tree) {
+    int n = I->n;
+    double total = 0.0;
+    for (int i=0;i<n;i++){ deg[i] = 0; in_tree[i] = 0; key[i] = 1e300; parent[i] = -1; }
+
+    /* Prim sur les villes 1..n-1 */
+    key[1] = 0.0;
+    for (int it=1; it<n; it++){
+        int u = -1;
+        double best = 1e300;
+        for (int v=1; v<n; v++){
+            if (!in_tree[v] && key[v] < best) { best = key[v]; u = v; }
+        }
+        in_tree[u] = 1;
+        total += key[u];
+        if (parent[u] >= 0) { deg[u]++; deg[parent[u]]++; }
+        for (int v=1; v<n; v++){
+            if (in_tree[v]) continue;
+            double w = inst_dist(I, u, v) + pi[u] + pi[v];
+            if (w < key[v]) { key[v] = w; parent[v] = u; }
+        }
+    }
+
+    /* Les deux arêtes les moins chères depuis la ville 0 */
+    int a = -1, b = -1;
+    double wa = 1e300, wb = 1e300;
+    for (int v=1; v<n; v++){
+        double w = inst_dist(I, 0, v) + pi[0] + pi[v];
+        if (w < wa) { wb = wa; b = a; wa = w; a = v; }
+        else if (w < wb) { wb = w; b = v; }
+    }
+    total += wa + wb;
+    deg[0] = 2;
+    deg[a]++; deg[b]++;
+    return total;
+}
+
+/* Borne inférieure de Held-Karp par montée de sous-gradient.
+ * ub: coût d'une tournée connue (borne supérieure) pour le pas de Polyak;
+ *     si ub <= 0, on utilise la tournée du plus proche voisin.
+ * Renvoie ceil(max L(pi)) : les distances étant entières, c'est encore une borne valide.
+ */
+long long one_tree_bound(const TspInstance *I, long long ub) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    if (n < 2) return 0;
+    if (n == 2) return inst_dist(I, 0, 1) + inst_dist(I, 1, 0);
+    if (n == 3) return inst_dist(I, 0, 1) + inst_dist(I, 1, 2) + inst_dist(I, 2, 0);   /* une seule tournée */
+
+    if (ub <= 0) ub = nearest_neighbor_cost(I);
+
+    double *pi = tsp_calloc(A, n, sizeof(double));
+    double *best_pi = tsp_calloc(A, n, sizeof(double));
+    double *key = tsp_alloc(A, n * sizeof(double));
+    int *parent = tsp_alloc(A, n * sizeof(int));
+    int *deg = tsp_alloc(A, n * sizeof(int));
+    char *in_tree = tsp_alloc(A, n);
+
+    double best_L = -1e300;
+    double lambda = 2.0;          /* facteur du pas de Polyak, divisé par 2 en cas de stagnation */
+    int stall = 0;
+    int period = n/2 > 20 ? n/2 : 20;
+
+    for (int it=0; it<BOUND_MAX_ITER; it++){
+        double W = one_tree_cost(I, pi, deg, key, parent, in_tree);
+        double sum_pi = 0.0;
+        for (int i=0;i<n;i++) sum_pi += pi[i];
+        double L = W - 2.0*sum_pi;
+
+        if (L > best_L + 1e-9) {
+            best_L = L;
+            memcpy(best_pi, pi, n * sizeof(double));
+            stall = 0;
+        } else if (++stall >= period) {
+            lambda *= 0.5;
+            stall = 0;
+        }
+
+        /* sous-gradient g[i] = deg[i] - 2 ; g = 0 => le 1-arbre est une tournée optimale */
+        long long norm2 = 0;
+        for (int i=0;i<n;i++) norm2 += (long long)(deg[i]-2)*(deg[i]-2);
+        if (norm2 == 0) break;
+        if (best_L > (double)ub - 1.0 + 1e-9) break;   /* borne entière = ub: optimal prouvé */
+        if (lambda < 1e-6) break;
+
+        double t = lambda * ((double)ub - L) / (double)norm2;
+        if (t <= 0) t = lambda * 1e-3;
+        for (int i=0;i<n;i++) pi[i] += t * (deg[i]-2);
+    }
+
+    tsp_free(A, pi); tsp_free(A, best_pi); tsp_free(A, key); tsp_free(A, parent); tsp_free(A, deg); tsp_free(A, in_tree);
+    return (long long)ceil(best_L - 1e-6);
+}
+
+/* Écart relatif (en %) entre le coût d'une tournée et une borne inférieure */
+double optimality_gap(long long tour_cost, long long bound) {
+    if (bound <= 0) return 0.0;
+    return 100.0 * (double)(tour_cost - bound) / (double)bound;
+}
+
+/* Borne de l'affectation (ATSP): chaque ville a exactement un successeur et un prédécesseur,
+ * sans la contrainte de connexité. Méthode hongroise O(n^3) avec potentiels; la diagonale
+ * est interdite par un coût supérieur à toute tournée. Valable aussi pour le cas symétrique,
+ * mais le 1-arbre y est en général plus serré.
+ */
+long long assignment_bound(const DistMatrix *d) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    if (n < 2) return 0;
+    long long maxd = 0;
+    for (int i=0;i<n;i++)
+        for (int j=0;j<n;j++) if (dm_get(d, i, j) > maxd) maxd = dm_get(d, i, j);
+    long long forbid = (maxd + 1) * n;
+
+    long long *u = tsp_calloc(A, n+1, sizeof(long long)), *v = tsp_calloc(A, n+1, sizeof(long long));
+    long long *minv = tsp_alloc(A, (n+1) * sizeof(long long));
+    int *p = tsp_calloc(A, n+1, sizeof(int)), *way = tsp_calloc(A, n+1, sizeof(int));
+    char *used = tsp_alloc(A, n+1);
+    for (int i=1;i<=n;i++) {
+        /* ajoute la ligne i par un plus court chemin augmentant (indices 1..n, 0 = fictif) */
+        p[0] = i;
+        int j0 = 0;
+        for (int j=0;j<=n;j++) { minv[j] = INFLL; used[j] = 0; }
+        do {
+            used[j0] = 1;
+            int i0 = p[j0], j1 = 0;
+            long long delta = INFLL;
+            for (int j=1;j<=n;j++) {
+                if (used[j]) continue;
+                long long c = (i0 == j ? forbid : dm_get(d, i0-1, j-1)) - u[i0] - v[j];
+                if (c < minv[j]) { minv[j] = c; way[j] = j0; }
+                if (minv[j] < delta) { delta = minv[j]; j1 = j; }
+            }
+            for (int j=0;j<=n;j++) {
+                if (used[j]) { u[p[j]] += delta; v[j] -= delta; }
+                else minv[j] -= delta;
+            }
+            j0 = j1;
+        } while (p[j0] != 0);
+        do {
+            int j1 = way[j0];
+            p[j0] = p[j1];
+            j0 = j1;
+        } while (j0);
+    }
+    long long cost = -v[0];
+    tsp_free(A, u); tsp_free(A, v); tsp_free(A, minv); tsp_free(A, p); tsp_free(A, way); tsp_free(A, used);
+    return cost;
+}
+
+/* Meilleure borne disponible: 1-arbre si la matrice est symétrique, affectation sinon */
+long long tsp_lower_bound(const TspInstance *I, long long ub) {
+    if (I->d && !dm_is_symmetric(I->d)) return assignment_bound(I->d);
+    return one_tree_bound(I, ub);
+}
+
+/* ---------- Heuristiques pour grandes instances: plus proche voisin + 2-opt / Or-opt ---------- */
+
+/* Au-delà de MAX_N, les méthodes exactes sont hors de portée. Les heuristiques travaillent
+ * sur une TspInstance: coordonnées (distances calculées à la volée) ou matrice complète.
+ */
+
+/* Réel uniforme dans [0, 1[ (deux tirages de 32 bits, 53 bits utiles) */
+static double rand_unit(TspContext *ctx) {
+    double hi = tsp_rand(ctx), lo = tsp_rand(ctx);
+    return (hi * 4294967296.0 + lo) / 18446744073709551616.0;
+}
+
+TspInstance generate_random_euclidean_instance(TspContext *ctx, int n) {
+    const TspAllocator *A = &ctx->alloc;
+    TspInstance I = { n, NULL, tsp_alloc(A, n * sizeof(double)), tsp_alloc(A, n * sizeof(double)),
+                      TSP_EUC_2D, A };
+    for (int i=0;i<n;i++){
+        I.x[i] = rand_unit(ctx) * MAX_COORD;
+        I.y[i] = rand_unit(ctx) * MAX_COORD;
+    }
+    return I;
+}
+
+void free_instance_coords(TspInstance *I) {
+    tsp_free(I->alloc, I->x);
+    tsp_free(I->alloc, I->y);
+    I->x = I->y = NULL;
+}
+
+long long tour_cost(const TspInstance *I, const int *tour) {
+    long long cost = 0;
+    for (int i=0;i<I->n;i++) cost += inst_dist(I, tour[i], tour[(i+1) % I->n]);
+    return cost;
+}
+
+/* --- Grille uniforme pour les recherches de voisins (instances à coordonnées) --- */
+
+typedef struct {
+    int g;              /* g x g cases */
+    double minx, miny, cell;
+    int *start;         /* start[c] .. start[c+1]-1 : villes de la case c dans items */
+    int *count;         /* nombre de villes encore actives dans la case (construction) */
+    int *items;
+    int *slot;          /* slot[v] = indice de v dans items */
+    int *cell_of;
+    const TspAllocator *alloc;
+} Grid;
+
+static Grid grid_build(const TspInstance *I) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    Grid G;
+    G.alloc = A;
+    double maxx = I->x[0], maxy = I->y[0];
+    G.minx = I->x[0]; G.miny = I->y[0];
+    for (int i=1;i<n;i++){
+        if (I->x[i] < G.minx) G.minx = I->x[i];
+        if (I->y[i] < G.miny) G.miny = I->y[i];
+        if (I->x[i] > maxx) maxx = I->x[i];
+        if (I->y[i] > maxy) maxy = I->y[i];
+    }
+    G.g = (int)sqrt(n / 2.0);           /* ~2 villes par case */
+    if (G.g < 1) G.g = 1;
+    double span = (maxx - G.minx > maxy - G.miny) ? maxx - G.minx : maxy - G.miny;
+    G.cell = (span > 0 ? span : 1.0) / G.g * (1.0 + 1e-9);
+
+    int ncell = G.g * G.g;
+    G.start = tsp_calloc(A, ncell + 1, sizeof(int));
+    G.count = tsp_alloc(A, ncell * sizeof(int));
+    G.items = tsp_alloc(A, n * sizeof(int));
+    G.slot = tsp_alloc(A, n * sizeof(int));
+    G.cell_of = tsp_alloc(A, n * sizeof(int));
+    for (int i=0;i<n;i++){
+        int cx = (int)((I->x[i] - G.minx) / G.cell);
+        int cy = (int)((I->y[i] - G.miny) / G.cell);
+        if (cx >= G.g) cx = G.g-1;
+        if (cy >= G.g) cy = G.g-1;
+        G.cell_of[i] = cy * G.g + cx;
+        G.start[G.cell_of[i] + 1]++;
+    }
+    for (int c=0;c<ncell;c++) G.start[c+1] += G.start[c];
+    for (int c=0;c<ncell;c++) G.count[c] = 0;
+    for (int i=0;i<n;i++){
+        int c = G.cell_of[i];
+        G.slot[i] = G.start[c] + G.count[c];
+        G.items[G.slot[i]] = i;
+        G.count[c]++;
+    }
+    return G;
+}
+
+static void grid_free(Grid *G) {
+    const TspAllocator *A = G->alloc;
+    tsp_free(A, G->start); tsp_free(A, G->count); tsp_free(A, G->items); tsp_free(A, G->slot); tsp_free(A, G->cell_of);
+}
+
+/* Retire v de sa case (échange avec le dernier élément actif de la case) */
+static void grid_remove(Grid *G, int v) {
+    int c = G->cell_of[v];
+    int last = G->start[c] + G->count[c] - 1;
+    int w = G->items[last];
+    G->items[G->slot[v]] = w;
+    G->slot[w] = G->slot[v];
+    G->items[last] = v;
+    G->slot[v] = last;
+    G->count[c]--;
+}
+
+/* Insère (w, dw) dans la liste triée best[0..*m-1] de capacité k */
+static void knn_insert(int *best, long long *bd, int *m, int k, int w, long long dw) {
+    if (*m == k && dw >= bd[k-1]) return;
+    int p = (*m < k) ? (*m)++ : k-1;
+    while (p > 0 && bd[p-1] > dw) { best[p] = best[p-1]; bd[p] = bd[p-1]; p--; }
+    best[p] = w; bd[p] = dw;
+}
+
+/* Parcourt les anneaux de cases autour de v jusqu'à ce que l'anneau suivant ne puisse plus
+ * rien apporter. only_active: ne considère que les villes encore dans la grille.
+ * Renvoie le nombre de voisins trouvés (<= k), triés par distance croissante.
+ */
+static int grid_knn(const TspInstance *I, const Grid *G, int v, int k, int only_active,
+             int *best, long long *bd) {
+    int m = 0;
+    double scale = 1.0;
+    inst_planar(I, &scale);
+    int cx = G->cell_of[v] % G->g, cy = G->cell_of[v] / G->g;
+    for (int r=0; r<G->g; r++){
+        /* toute ville de l'anneau r est à distance >= (r-1)*cell de v (en coordonnées) */
+        if (m == k && (double)bd[k-1] < scale * (r-1) * G->cell - 1.0) break;
+        for (int y=cy-r; y<=cy+r; y++){
+            if (y < 0 || y >= G->g) continue;
+            int step = (y == cy-r || y == cy+r) ? 1 : 2*r;   /* bord de l'anneau seulement */
+            for (int x=cx-r; x<=cx+r; x+=step){
+                if (x < 0 || x >= G->g) continue;
+                int c = y * G->g + x;
+                int end = G->start[c] + (only_active ? G->count[c] : G->start[c+1] - G->start[c]);
+                for (int s=G->start[c]; s<end; s++){
+                    int w = G->items[s];
+                    if (w == v) continue;
+                    knn_insert(best, bd, &m, k, w, inst_dist(I, v, w));
+                }
+            }
+        }
+    }
+    return m;
+}
+
+/* Listes de candidats: neigh[v*k .. v*k+k-1] = k plus proches voisins de v (triés).
+ * Grille en O(n k) pour les coordonnées planes, balayage O(n^2) sinon (matrice, GEO).
+ */
+int *build_neighbor_lists(const TspInstance *I, int k) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    int *neigh = tsp_alloc(A, (size_t)n * k * sizeof(int));
+    long long *bd = tsp_alloc(A, k * sizeof(long long));
+    double scale;
+    if (!inst_planar(I, &scale)) {
+        for (int v=0; v<n; v++){
+            int m = 0;
+            for (int w=0; w<n; w++) if (w != v) knn_insert(&neigh[(size_t)v*k], bd, &m, k, w, inst_dist(I, v, w));
+        }
+    } else {
+        Grid G = grid_build(I);
+        for (int v=0; v<n; v++) grid_knn(I, &G, v, k, 0, &neigh[(size_t)v*k], bd);
+        grid_free(&G);
+    }
+    tsp_free(A, bd);
+    return neigh;
+}
+
+/* Plus proche voisin depuis la ville 0. Les listes de candidats étant triées, le premier
+ * voisin non visité est le plus proche; sinon on cherche dans la grille (ou la matrice).
+ */
+void nearest_neighbor_tour(const TspInstance *I, const int *neigh, int k, int *tour) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    char *seen = tsp_calloc(A, n, 1);
+    double scale;
+    int planar = inst_planar(I, &scale);
+    Grid G;
+    if (planar) G = grid_build(I);
+    int cur = 0;
+    seen[0] = 1;
+    tour[0] = 0;
+    if (planar) grid_remove(&G, 0);
+    for (int step=1; step<n; step++){
+        int nxt = -1;
+        for (int t=0; t<k; t++){
+            int w = neigh[(size_t)cur*k + t];
+            if (!seen[w]) { nxt = w; break; }
+        }
+        if (nxt < 0) {
+            if (!planar) {
+                for (int v=0; v<n; v++)
+                    if (!seen[v] && (nxt < 0 || inst_dist(I, cur, v) < inst_dist(I, cur, nxt))) nxt = v;
+            } else {
+                long long bd;
+                grid_knn(I, &G, cur, 1, 1, &nxt, &bd);
+            }
+        }
+        if (nxt < 0) break;   /* impossible: il reste au moins une ville non visitée */
+        seen[nxt] = 1;
+        if (planar) grid_remove(&G, nxt);
+        tour[step] = nxt;
+        cur = nxt;
+    }
+    if (planar) grid_free(&G);
+    tsp_free(A, seen);
+}
+
+/* --- Tournée en tableau + index de position --- */
+
+typedef struct {
+    int n;
+    int *tour;   /* tour[i] = ville en position i */
+    int *pos;    /* pos[v] = position de la ville v */
+    int *log;    /* journal des inversions (position, longueur) pour annuler, ou NULL */
+    int nlog, caplog;
+    int log_overflow;
+} TourArray;
+
+static inline int tour_next(const TourArray *T, int v) {
+    int p = T->pos[v] + 1;
+    return T->tour[p == T->n ? 0 : p];
+}
+static inline int tour_prev(const TourArray *T, int v) {
+    int p = T->pos[v] - 1;
+    return T->tour[p < 0 ? T->n - 1 : p];
+}
+
+/* Inverse les 'len' positions à partir de i (circulairement). Opération involutive. */
+static void tour_reverse_positions(TourArray *T, int i, int len) {
+    int n = T->n;
+    int j = i + len - 1;
+    if (j >= n) j -= n;
+    for (int s=0; s<len/2; s++){
+        int a = T->tour[i], b = T->tour[j];
+        T->tour[i] = b; T->pos[b] = i;
+        T->tour[j] = a; T->pos[a] = j;
+        if (++i == n) i = 0;
+        if (--j < 0) j = n - 1;
+    }
+}
+
+/* Inverse le chemin de 'from' à 'to' (sens direct). Si ce chemin dépasse la moitié de la
+ * tournée, on inverse le complément: même cycle, orientation opposée, coût <= n/2.
+ */
+static void tour_reverse_path(TourArray *T, int from, int to) {
+    int n = T->n;
+    int i = T->pos[from], j = T->pos[to];
+    int len = j - i; if (len < 0) len += n;
+    len++;
+    if (2*len > n) {
+        i = (j + 1 == n) ? 0 : j + 1;
+        len = n - len;
+    }
+    if (T->log) {
+        if (T->nlog + 2 <= T->caplog) { T->log[T->nlog++] = i; T->log[T->nlog++] = len; }
+        else T->log_overflow = 1;
+    }
+    tour_reverse_positions(T, i, len);
+}
+
+/* Annule les inversions journalisées (dans l'ordre inverse) */
+static void tour_undo_log(TourArray *T) {
+    while (T->nlog > 0) {
+        int len = T->log[--T->nlog];
+        int i = T->log[--T->nlog];
+        tour_reverse_positions(T, i, len);
+    }
+}
+
+/* Mouvement 2-opt: retire (a,b) et (c,d), ajoute (a,c) et (b,d).
+ * Précondition: b = suivant(a) et d = suivant(c), ou b = précédent(a) et d = précédent(c).
+ */
+static void two_opt_move(TourArray *T, int a, int b, int c, int d) {
+    if (tour_next(T, a) == b) tour_reverse_path(T, b, c);
+    else tour_reverse_path(T, a, d);
+}
+
+/* --- Recherche locale 2-opt + Or-opt avec bits "don't look" --- */
+
+typedef struct {
+    int *q;
+    char *in;
+    int head, size, cap;
+} ActiveQueue;
+
+static void aq_push(ActiveQueue *Q, int v) {
+    if (Q->in[v]) return;
+    Q->in[v] = 1;
+    Q->q[(Q->head + Q->size) % Q->cap] = v;
+    Q->size++;
+}
+static int aq_pop(ActiveQueue *Q) {
+    int v = Q->q[Q->head];
+    Q->head = (Q->head + 1) % Q->cap;
+    Q->size--;
+    Q->in[v] = 0;
+    return v;
+}
+
+/* Cherche un 2-opt améliorant autour de a (les deux sens). Applique le premier trouvé
+ * et renvoie son gain (0 si aucun).
+ */
+static long long try_two_opt(const TspInstance *I, TourArray *T, const int *neigh, int k,
+                       int a, ActiveQueue *Q) {
+    for (int dir=0; dir<2; dir++){
+        int b = dir ? tour_prev(T, a) : tour_next(T, a);
+        long long d_ab = inst_dist(I, a, b);
+        for (int t=0; t<k; t++){
+            int c = neigh[(size_t)a*k + t];
+            long long d_ac = inst_dist(I, a, c);
+            if (d_ac >= d_ab) break;              /* listes triées: plus de gain possible */
+            int d = dir ? tour_prev(T, c) : tour_next(T, c);
+            if (c == b || d == a) continue;
+            long long delta = d_ac + inst_dist(I, b, d) - d_ab - inst_dist(I, c, d);
+            if (delta < 0) {
+                two_opt_move(T, a, b, c, d);
+                aq_push(Q, a); aq_push(Q, b); aq_push(Q, c); aq_push(Q, d);
+                return -delta;
+            }
+        }
+    }
+    return 0;
+}
+
+/* Or-opt: déplace le segment de 1 à 3 villes commençant en s1 entre deux villes voisines
+ * (u,v) d'une ville candidate, éventuellement inversé. Réalisé par 2 ou 3 mouvements 2-opt.
+ * Renvoie le gain (0 si aucun mouvement améliorant).
+ */
+static long long try_or_opt(const TspInstance *I, TourArray *T, const int *neigh, int k,
+                      int s1, ActiveQueue *Q) {
+    int n = T->n;
+    for (int len=1; len<=3 && len+3<=n; len++){
+        int s2 = s1;
+        for (int i=1;i<len;i++) s2 = tour_next(T, s2);
+        int p = tour_prev(T, s1), nx = tour_next(T, s2);
+        long long g_remove = inst_dist(I, p, s1) + inst_dist(I, s2, nx) - inst_dist(I, p, nx);
+        if (g_remove <= 0) continue;
+
+        for (int end=0; end<2; end++){
+            int sv = end ? s2 : s1;
+            for (int t=0; t<k; t++){
+                int c = neigh[(size_t)sv*k + t];
+                if (inst_dist(I, sv, c) >= g_remove) break;
+                for (int side=0; side<2; side++){
+                    int u = side ? tour_prev(T, c) : c;
+                    int v = tour_next(T, u);
+                    /* (u,v) ne doit toucher ni le segment ni les arêtes retirées */
+                    int in_seg = 0;
+                    for (int x=s1, i=0; i<len; x=tour_next(T, x), i++)
+                        if (x == u || x == v) in_seg = 1;
+                    if (in_seg || u == p || v == p) continue;
+                    long long d_uv = inst_dist(I, u, v);
+                    long long add_fwd = inst_dist(I, u, s1) + inst_dist(I, s2, v) - d_uv;
+                    long long add_rev = inst_dist(I, u, s2) + inst_dist(I, s1, v) - d_uv;
+                    int reversed = len > 1 && add_rev < add_fwd;
+                    long long add = reversed ? add_rev : add_fwd;
+                    if (add >= g_remove) continue;
+
+                    /* p s1..s2 nx ... u v  ->  p u ... nx s2..s1 v  ->  p nx ... u s2..s1 v */
+                    two_opt_move(T, p, s1, u, v);
+                    if (u != nx) two_opt_move(T, p, u, nx, s2);
+                    if (!reversed) two_opt_move(T, u, s2, s1, v);
+                    aq_push(Q, p); aq_push(Q, nx); aq_push(Q, s1);
+                    aq_push(Q, s2); aq_push(Q, u); aq_push(Q, v);
+                    return g_remove - add;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static long long lk_improve(const TspInstance *I, TourArray *T, const int *neigh, int k,
+                            int t1, ActiveQueue *Q);
+
+/* Vide la file des villes actives: 2-opt (ou mouvement LK si use_lk) puis Or-opt.
+ * Renvoie le gain total.
+ */
+static long long ls_run(const TspInstance *I, TourArray *T, const int *neigh, int k,
+                        ActiveQueue *Q, int use_lk) {
+    long long gain = 0;
+    while (Q->size > 0) {
+        int a = aq_pop(Q);
+        long long g = use_lk ? lk_improve(I, T, neigh, k, a, Q) : try_two_opt(I, T, neigh, k, a, Q);
+        if (g == 0) g = try_or_opt(I, T, neigh, k, a, Q);
+        gain += g;
+    }
+    return gain;
+}
+
+/* Améliore 'tour' (tableau de n villes) jusqu'à un optimum local 2-opt + Or-opt */
+void local_search_2opt_oropt(const TspInstance *I, int *tour, const int *neigh, int k) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    if (n < 5) return;
+    TourArray T = { n, tour, tsp_alloc(A, n * sizeof(int)) };
+    for (int i=0;i<n;i++) T.pos[tour[i]] = i;
+
+    ActiveQueue Q = { tsp_alloc(A, n * sizeof(int)), tsp_calloc(A, n, 1), 0, 0, n };
+    for (int i=0;i<n;i++) aq_push(&Q, tour[i]);
+
+    ls_run(I, &T, neigh, k, &Q, 0);
+    tsp_free(A, T.pos);
+    tsp_free(A, Q.q);
+    tsp_free(A, Q.in);
+}
+
+/* Heuristique complète: listes de candidats, plus proche voisin, 2-opt + Or-opt.
+ * tour doit avoir n cases; renvoie le coût de la tournée trouvée.
+ */
+long long tsp_local_search(const TspInstance *I, int *tour) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    if (n <= 3) {
+        for (int i=0;i<n;i++) tour[i] = i;
+        return tour_cost(I, tour);
+    }
+    int k = NEIGHBOR_K < n-1 ? NEIGHBOR_K : n-1;
+    int *neigh = build_neighbor_lists(I, k);
+    nearest_neighbor_tour(I, neigh, k, tour);
+    local_search_2opt_oropt(I, tour, neigh, k);
+    tsp_free(A, neigh);
+    return tour_cost(I, tour);
+}
+
+/* ---------- Lin-Kernighan (profondeur variable) + perturbations, multi-thread ---------- */
+
+/* Mouvement LK réalisé comme une chaîne de mouvements 2-opt (t1 fixe):
+ *   on retire (t1,t2), on ajoute (t2,t3) avec g = d(t1,t2) - d(t2,t3) > 0, on retire (t3,t4)
+ *   et on referme par (t4,t1). Si la tournée refermée n'est pas meilleure, t4 devient le
+ *   nouveau t2 et on continue, jusqu'à LK_MAX_DEPTH niveaux. Les niveaux sans succès sont
+ *   annulés (un 2-opt s'annule par un autre 2-opt).
+ * Recherche itérée: perturbation "double-bridge" locale (échange de deux segments voisins,
+ * 3 arêtes modifiées) puis LK sur les extrémités touchées; on garde si non pire, sinon on
+ * annule grâce au journal des inversions.
+ */
+
+#define KICK_WINDOW 50        /* taille max des segments échangés par la perturbation */
+#define UNDO_LOG_CAP (1<<16)
+
+static const int lk_breadth[LK_MAX_DEPTH] = { 5, 3, 1, 1, 1 };
+
+/* Horloge murale monotone (l'échéance porte sur le temps réel, pas le temps CPU) */
+#ifdef _WIN32
+double wall_seconds() {
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+}
+#else
+double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+#endif
+
+/* Un niveau de la recherche LK. Renvoie le gain si une tournée meilleure a été obtenue
+ * (les mouvements sont alors conservés), 0 sinon (tout est annulé).
+ */
+static long long lk_step(const TspInstance *I, TourArray *T, const int *neigh, int k,
+                         int t1, int t2, long long g, int depth, int *touched, int *ntouched) {
+    for (int t=0, tried=0; t<k && tried<lk_breadth[depth]; t++){
+        int t3 = neigh[(size_t)t2*k + t];
+        long long g1 = g - inst_dist(I, t2, t3);
+        if (g1 <= 0) break;
+        if (t3 == t1 || t3 == tour_next(T, t2) || t3 == tour_prev(T, t2)) continue;
+        /* une annulation peut inverser l'orientation du tableau: on la relit à chaque essai */
+        int t4 = (tour_prev(T, t2) == t1) ? tour_prev(T, t3) : tour_next(T, t3);
+        if (t4 == t2 || t4 == t1) continue;
+        tried++;
+
+        long long g2 = g1 + inst_dist(I, t3, t4);
+        two_opt_move(T, t2, t1, t3, t4);          /* ajoute (t2,t3) et (t1,t4) */
+        touched[(*ntouched)++] = t3;
+        touched[(*ntouched)++] = t4;
+
+        long long closed = g2 - inst_dist(I, t4, t1);
+        if (closed > 0) return closed;
+        if (depth + 1 < LK_MAX_DEPTH) {
+            long long r = lk_step(I, T, neigh, k, t1, t4, g2, depth + 1, touched, ntouched);
+            if (r > 0) return r;
+        }
+        two_opt_move(T, t2, t3, t1, t4);          /* annule */
+        *ntouched -= 2;
+    }
+    return 0;
+}
+
+/* Mouvement LK depuis t1 (les deux voisins de tournée comme t2). Renvoie le gain. */
+static long long lk_improve(const TspInstance *I, TourArray *T, const int *neigh, int k,
+                            int t1, ActiveQueue *Q) {
+    int touched[2 + 2*LK_MAX_DEPTH];
+    int succ = tour_next(T, t1), pred = tour_prev(T, t1);
+    for (int dir=0; dir<2; dir++){
+        int t2 = dir ? pred : succ;
+        int nt = 0;
+        long long gain = lk_step(I, T, neigh, k, t1, t2, inst_dist(I, t1, t2), 0, touched, &nt);
+        if (gain > 0) {
+            aq_push(Q, t1); aq_push(Q, t2);
+            for (int i=0;i<nt;i++) aq_push(Q, touched[i]);
+            return gain;
+        }
+    }
+    return 0;
+}
+
+typedef struct {
+    const TspInstance *I;
+    const int *neigh;
+    int k;
+    const int *start_tour;
+    long long start_cost;
+    double t0, deadline;
+    unsigned seed;
+    int id;
+    pthread_mutex_t *lock;
+    LkResult *R;
+    int *cap_timeline;     /* capacité de R->timeline (partagée, protégée par lock) */
+} LkWorker;
+
+static void lk_publish(LkWorker *W, const int *tour, long long cost) {
+    pthread_mutex_lock(W->lock);
+    LkResult *R = W->R;
+    if (cost < R->cost) {
+        R->cost = cost;
+        memcpy(R->tour, tour, W->I->n * sizeof(int));
+        if (R->ntimeline == *W->cap_timeline) {
+            /* l'allocateur n'a pas de realloc: copie dans un bloc deux fois plus grand */
+            LkEvent *grown = tsp_alloc(R->alloc, 2 * *W->cap_timeline * sizeof(LkEvent));
+            if (grown) {
+                memcpy(grown, R->timeline, R->ntimeline * sizeof(LkEvent));
+                tsp_free(R->alloc, R->timeline);
+                R->timeline = grown;
+                *W->cap_timeline *= 2;
+            }
+        }
+        if (R->ntimeline < *W->cap_timeline) {
+            LkEvent ev = { wall_seconds() - W->t0, cost, W->id };
+            R->timeline[R->ntimeline++] = ev;
+        }
+    }
+    pthread_mutex_unlock(W->lock);
+}
+
+/* Perturbation: A B C D -> A C B D avec B, C consécutifs de longueur <= KICK_WINDOW.
+ * Sauvegarde la fenêtre dans 'saved' (pour annulation) et renvoie la variation de coût.
+ */
+static long long double_bridge_kick(const TspInstance *I, TourArray *T, unsigned *rng,
+                                    int *saved, int *p_start, int *p_len, ActiveQueue *Q) {
+    int n = T->n;
+    int maxseg = (n - 2) / 2 < KICK_WINDOW ? (n - 2) / 2 : KICK_WINDOW;
+    int lb = 1 + xorshift32(rng) % maxseg;
+    int lc = 1 + xorshift32(rng) % maxseg;
+    int i = xorshift32(rng) % n;                  /* dernière position de A */
+    int len = lb + lc;
+    int b0 = (i + 1) % n, c0 = (i + 1 + lb) % n, e = (i + len) % n, f = (e + 1) % n;
+
+    int a = T->tour[i], b1 = T->tour[b0], b2 = T->tour[(c0 - 1 + n) % n];
+    int c1 = T->tour[c0], c2 = T->tour[e], d1 = T->tour[f];
+    long long delta = inst_dist(I, a, c1) + inst_dist(I, c2, b1) + inst_dist(I, b2, d1)
+                    - inst_dist(I, a, b1) - inst_dist(I, b2, c1) - inst_dist(I, c2, d1);
+
+    for (int s=0; s<len; s++) saved[s] = T->tour[(b0 + s) % n];
+    for (int s=0; s<lc; s++) {
+        int p = (b0 + s) % n;
+        T->tour[p] = saved[lb + s]; T->pos[T->tour[p]] = p;
+    }
+    for (int s=0; s<lb; s++) {
+        int p = (b0 + lc + s) % n;
+        T->tour[p] = saved[s]; T->pos[T->tour[p]] = p;
+    }
+    *p_start = b0;
+    *p_len = len;
+    aq_push(Q, a); aq_push(Q, b1); aq_push(Q, b2);
+    aq_push(Q, c1); aq_push(Q, c2); aq_push(Q, d1);
+    return delta;
+}
+
+static void *lk_worker(void *arg) {
+    LkWorker *W = arg;
+    const TspInstance *I = W->I;
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    unsigned rng = W->seed ? W->seed : 1;
+
+    int *tour = tsp_alloc(A, n * sizeof(int));
+    int *best = tsp_alloc(A, n * sizeof(int));
+    int *saved = tsp_alloc(A, 2 * KICK_WINDOW * sizeof(int));
+    memcpy(tour, W->start_tour, n * sizeof(int));
+    TourArray T = { n, tour, tsp_alloc(A, n * sizeof(int)), NULL, 0, 0, 0 };
+    for (int i=0;i<n;i++) T.pos[tour[i]] = i;
+    ActiveQueue Q = { tsp_alloc(A, n * sizeof(int)), tsp_calloc(A, n, 1), 0, 0, n };
+
+    /* Optimum local LK de départ */
+    for (int i=0;i<n;i++) aq_push(&Q, tour[i]);
+    long long cur = W->start_cost - ls_run(I, &T, W->neigh, W->k, &Q, 1);
+    memcpy(best, tour, n * sizeof(int));
+    lk_publish(W, tour, cur);
+
+    long long kicks = 0;
+    T.log = tsp_alloc(A, UNDO_LOG_CAP * sizeof(int));
+    T.caplog = UNDO_LOG_CAP;
+    while (n >= 8 && wall_seconds() < W->deadline) {
+        int ks, kl;
+        T.nlog = 0;
+        T.log_overflow = 0;
+        long long cand = cur + double_bridge_kick(I, &T, &rng, saved, &ks, &kl, &Q);
+        cand -= ls_run(I, &T, W->neigh, W->k, &Q, 1);
+        kicks++;
+
+        if (cand <= cur) {
+            if (cand < cur) {
+                memcpy(best, tour, n * sizeof(int));
+                lk_publish(W, tour, cand);
+            }
+            cur = cand;
+        } else if (!T.log_overflow) {
+            tour_undo_log(&T);
+            for (int s=0; s<kl; s++) {
+                int p = (ks + s) % n;
+                T.tour[p] = saved[s]; T.pos[saved[s]] = p;
+            }
+        } else {
+            memcpy(tour, best, n * sizeof(int));
+            for (int i=0;i<n;i++) T.pos[tour[i]] = i;
+            cur = tour_cost(I, tour);
+        }
+    }
+
+    pthread_mutex_lock(W->lock);
+    W->R->kicks += kicks;
+    pthread_mutex_unlock(W->lock);
+
+    tsp_free(A, T.log); tsp_free(A, T.pos); tsp_free(A, Q.q); tsp_free(A, Q.in);
+    tsp_free(A, tour); tsp_free(A, best); tsp_free(A, saved);
+    return NULL;
+}
+
+/* Lin-Kernighan itéré: construction + 2-opt/Or-opt, puis nthreads recherches indépendantes
+ * (graines différentes) jusqu'à l'échéance time_budget (secondes, horloge murale).
+ */
+LkResult tsp_lin_kernighan(const TspInstance *I, double time_budget, int nthreads, unsigned seed) {
+    const TspAllocator *A = I->alloc;
+    int n = I->n;
+    double t0 = wall_seconds();
+    LkResult R = { INFLL, tsp_alloc(A, n * sizeof(int)), tsp_alloc(A, 16 * sizeof(LkEvent)), 0, 0, A };
+    if (n <= 3) {
+        for (int i=0;i<n;i++) R.tour[i] = i;
+        R.cost = tour_cost(I, R.tour);
+        return R;
+    }
+    if (nthreads < 1) nthreads = 1;
+
+    int k = NEIGHBOR_K < n-1 ? NEIGHBOR_K : n-1;
+    int *neigh = build_neighbor_lists(I, k);
+    int *start = tsp_alloc(A, n * sizeof(int));
+    nearest_neighbor_tour(I, neigh, k, start);
+    local_search_2opt_oropt(I, start, neigh, k);
+    long long start_cost = tour_cost(I, start);
+
+    int cap_timeline = 16;
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+    pthread_t *th = tsp_alloc(A, nthreads * sizeof(pthread_t));
+    LkWorker *W = tsp_alloc(A, nthreads * sizeof(LkWorker));
+    for (int t=0; t<nthreads; t++){
+        LkWorker w = { I, neigh, k, start, start_cost, t0, t0 + time_budget,
+                       seed * 2654435761u + 97u * (t + 1), t, &lock, &R, &cap_timeline };
+        W[t] = w;
+    }
+    for (int t=1; t<nthreads; t++) pthread_create(&th[t], NULL, lk_worker, &W[t]);
+    lk_worker(&W[0]);
+    for (int t=1; t<nthreads; t++) pthread_join(th[t], NULL);
+
+    pthread_mutex_destroy(&lock);
+    tsp_free(A, th); tsp_free(A, W); tsp_free(A, start); tsp_free(A, neigh);
+    return R;
+}
+
+void free_lk_result(LkResult *R) {
+    tsp_free(R->alloc, R->tour);
+    tsp_free(R->alloc, R->timeline);
+}
+
+/* ---------- Held-Karp "pull" vectorisé (SIMD min-plus) ---------- */
+
+/* Variante "pull" de held_karp: pour un sous-ensemble S (villes 1..n-1) et k dans S,
+ *     dp[S][k] = min_{j dans S\{k}} dp[S\{k}][j] + d(j,k)
+ * La ligne dp[S\{k}] et la colonne d(.,k) (copie transposée de la matrice: d->data_t si
+ * dm_build_transpose l'a construite, sinon une copie privée libérée en fin d'appel) sont
+ * contiguës: le min est un produit min-plus vectorisé sur j (8 voies AVX2 ou 4 voies
+ * SSE4.1, entiers 32 bits). La colonne est lue dans son type réel (uint8_t, uint16_t ou
+ * uint32_t) et élargie à la volée. Les lignes dp sont indexées par ville (0..n-1, la ville 0
+ * n'appartient jamais à S): les j hors de S\{k} valent HK32_INF dans dp et ne gagnent jamais,
+ * ce qui tient lieu de masque. Une seule écriture par (S,k), au lieu d'une écriture dispersée
+ * par k en "push". Choix du noyau à l'exécution (__builtin_cpu_supports), repli scalaire sinon.
+ * Mémoire: 2^(n-1) lignes de pad8(n) entiers 32 bits (n=24: ~800 Mo).
+ */
+
+#define HK32_INF 0x3fffffff       /* INF + distance ne déborde pas en 32 bits */
+
+/* min_j a[j] + col[j] pour j < len (len multiple de 8), col du type de la matrice */
+typedef int32_t (*minplus_fn)(const int32_t *a, const void *col, int len);
+
+#define MINPLUS_SCALAR(NAME, T) \
+static int32_t NAME(const int32_t *a, const void *col, int len) { \
+    const T *b = (const T *)col; \
+    int32_t best = HK32_INF; \
+    for (int j=0;j<len;j++) { \
+        int32_t v = a[j] + (int32_t)b[j]; \
+        if (v < best) best = v; \
+    } \
+    return best; \
+}
+
+MINPLUS_SCALAR(minplus_scalar_u8, uint8_t)
+MINPLUS_SCALAR(minplus_scalar_u16, uint16_t)
+MINPLUS_SCALAR(minplus_scalar_u32, uint32_t)
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HK_HAVE_X86_SIMD 1
+
+/* Chargement de 4 (SSE4.1) ou 8 (AVX2) distances consécutives, élargies en entiers 32 bits */
+#define SSE_LOAD_U8(p)   _mm_cvtepu8_epi32(_mm_cvtsi32_si128(load_u32((const uint8_t *)(p))))
+#define SSE_LOAD_U16(p)  _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(p)))
+#define SSE_LOAD_U32(p)  _mm_load_si128((const __m128i *)(p))
+#define AVX2_LOAD_U8(p)  _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(p)))
+#define AVX2_LOAD_U16(p) _mm256_cvtepu16_epi32(_mm_load_si128((const __m128i *)(p)))
+#define AVX2_LOAD_U32(p) _mm256_load_si256((const __m256i *)(p))
+
+static inline int load_u32(const uint8_t *p) {
+    int v;
+    memcpy(&v, p, sizeof v);
+    return v;
+}
+
+#define MINPLUS_SSE41(NAME, T, LOAD) \
+__attribute__((target("sse4.1"))) \
+static int32_t NAME(const int32_t *a, const void *col, int len) { \
+    const T *b = (const T *)col; \
+    __m128i best = _mm_set1_epi32(HK32_INF); \
+    for (int j=0;j<len;j+=4) { \
+        __m128i va = _mm_load_si128((const __m128i *)(a + j)); \
+        best = _mm_min_epi32(best, _mm_add_epi32(va, LOAD(b + j))); \
+    } \
+    best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(1, 0, 3, 2))); \
+    best = _mm_min_epi32(best, _mm_shuffle_epi32(best, _MM_SHUFFLE(2, 3, 0, 1))); \
+    return _mm_cvtsi128_si32(best); \
+}
+
+#define MINPLUS_AVX2(NAME, T, LOAD) \
+__attribute__((target("avx2"))) \
+static int32_t NAME(const int32_t *a, const void *col, int len) { \
+    const T *b = (const T *)col; \
+    __m256i best = _mm256_set1_epi32(HK32_INF); \
+    for (int j=0;j<len;j+=8) { \
+        __m256i va = _mm256_load_si256((const __m256i *)(a + j)); \
+        best = _mm256_min_epi32(best, _mm256_add_epi32(va, LOAD(b + j))); \
+    } \
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(best), _mm256_extracti128_si256(best, 1)); \
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2))); \
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1))); \
+    return _mm_cvtsi128_si32(m); \
+}
+
+MINPLUS_SSE41(minplus_sse41_u8, uint8_t, SSE_LOAD_U8)
+MINPLUS_SSE41(minplus_sse41_u16, uint16_t, SSE_LOAD_U16)
+MINPLUS_SSE41(minplus_sse41_u32, uint32_t, SSE_LOAD_U32)
+MINPLUS_AVX2(minplus_avx2_u8, uint8_t, AVX2_LOAD_U8)
+MINPLUS_AVX2(minplus_avx2_u16, uint16_t, AVX2_LOAD_U16)
+MINPLUS_AVX2(minplus_avx2_u32, uint32_t, AVX2_LOAD_U32)
+#endif
+
+/* Noyau min-plus retenu pour ce processeur et des distances sur width octets (1, 2 ou 4);
+ * *name reçoit son nom (affichage) */
+static minplus_fn select_minplus_kernel(int width, const char **name) {
+#ifdef HK_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        *name = "avx2";
+        return width == 1 ? minplus_avx2_u8 : width == 2 ? minplus_avx2_u16 : minplus_avx2_u32;
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        *name = "sse4.1";
+        return width == 1 ? minplus_sse41_u8 : width == 2 ? minplus_sse41_u16 : minplus_sse41_u32;
+    }
+#endif
+    *name = "scalaire";
+    return width == 1 ? minplus_scalar_u8 : width == 2 ? minplus_scalar_u16 : minplus_scalar_u32;
+}
+
+/* Nom du noyau min-plus utilisé par held_karp_simd sur ce processeur */
+const char *held_karp_simd_kernel(void) {
+    const char *name;
+    select_minplus_kernel(1, &name);
+    return name;
+}
+
+/* d n'est pas modifiée: sans d->data_t, les colonnes sont lues dans une copie privée */
+long long held_karp_simd(const DistMatrix *d) {
+    const TspAllocator *A = d->alloc;
+    int n = d->n;
+    long long maxd = 0;
+    for (int i=0;i<n;i++)
+        for (int j=0;j<n;j++) if (dm_get(d, i, j) > maxd) maxd = dm_get(d, i, j);
+    /* repli sur la version 64 bits si les coûts ne tiennent pas sous HK32_INF */
+    if (n < 3 || d->width > 4 || maxd * n >= HK32_INF) return held_karp(d);
+    void *own = d->data_t ? NULL : dm_transpose_copy(d);
+    if (!d->data_t && !own) return held_karp(d);
+
+    const char *name;
+    minplus_fn minplus = select_minplus_kernel(d->width, &name);
+    int m = n - 1;                         /* villes 1..n-1 -> bits 0..m-1 */
+    int stride = (n + 7) / 8 * 8;          /* 8 entiers = 32 octets: chargements alignés */
+    size_t nsub = (size_t)1 << m;
+    /* colonne k de la matrice: d(j,k) pour j = 0..stride-1 (d->stride >= stride, complétée par 0) */
+    const char *cols = (const char *)(own ? own : d->data_t);
+    size_t col_bytes = (size_t)d->stride * d->width;
+
+    int32_t *dp = tsp_alloc_aligned(A, nsub * stride * sizeof(int32_t));
+    if (!dp) {
+        tsp_free(A, own);
+        return held_karp(d);
+    }
+    for (size_t i=0; i<nsub*stride; i++) dp[i] = HK32_INF;
+    for (int k=1;k<n;k++) dp[((size_t)1 << (k-1)) * stride + k] = (int32_t)dm_get(d, 0, k);
+
+    for (size_t S=1; S<nsub; S++) {
+        if ((S & (S-1)) == 0) continue;    /* singletons déjà initialisés */
+        int32_t *row = &dp[S * stride];
+        for (size_t rest=S; rest; rest &= rest-1) {
+            int b = __builtin_ctzll(rest);
+            size_t prev = S ^ ((size_t)1 << b);
+            row[b+1] = minplus(&dp[prev * stride], cols + (size_t)(b+1) * col_bytes, stride);
+        }
+    }
+
+    long long best = INFLL;
+    const int32_t *last = &dp[(nsub - 1) * stride];
+    for (int k=1;k<n;k++) {
+        long long total = (long long)last[k] + dm_get(d, k, 0);
+        if (total < best) best = total;
+    }
+    tsp_free(A, dp);
+    tsp_free(A, own);
+    return best;
+}
+
+/* ---------- Held-Karp spécialisé à la compilation (n fixé, n <= 16) ---------- */
+
+/* Une fonction par n, générée par macro: N est une constante, donc les bornes (1 << (N-1)),
+ * les pas d'indice et les boucles internes (N-1 tours) sont connus du compilateur, qui les
+ * déroule entièrement. Formulation "pull" sans branchement: dp[S][k] vaut INFLL pour k hors
+ * de S, si bien que le minimum porte sur toutes les villes j (INFLL + d ne déborde pas).
+ * La matrice est recopiée dans un tableau local D[N][N]; pour N <= HK_STACK_MAX_N la table dp
+ * (2^(N-1) * (N-1) entrées, 176 Ko pour N = 12) est elle aussi sur la pile.
+ */
+
+#define HK_STACK_MAX_N 12
+
+#if defined(__clang__)
+#define HK_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+#define HK_UNROLL _Pragma("GCC unroll 16")
+#else
+#define HK_UNROLL
+#endif
+
+/* Corps commun: dp (M = N-1 colonnes) déjà déclaré, D rempli */
+#define HK_FIXED_BODY(N) \
+    for (uint32_t S=1; S < (1u << (N-1)); S++) { \
+        long long *row = &dp[(size_t)S * (N-1)]; \
+        if (!(S & (S-1))) { \
+            HK_UNROLL for (int k=0;k<N-1;k++) row[k] = (S >> k) & 1 ? D[0][k+1] : INFLL; \
+            continue; \
+        } \
+        HK_UNROLL for (int k=0;k<N-1;k++) { \
+            const long long *prev = &dp[(size_t)(S & ~(1u << k)) * (N-1)]; \
+            long long best = INFLL; \
+            HK_UNROLL for (int j=0;j<N-1;j++) { \
+                long long v = prev[j] + D[j+1][k+1]; \
+                best = v < best ? v : best; \
+            } \
+            row[k] = (S >> k) & 1 ? best : INFLL; \
+        } \
+    } \
+    long long best = INFLL; \
+    const long long *last = &dp[(size_t)((1u << (N-1)) - 1) * (N-1)]; \
+    HK_UNROLL for (int j=0;j<N-1;j++) { \
+        long long v = last[j] + D[j+1][0]; \
+        best = v < best ? v : best; \
+    }
+
+#define HK_FIXED_LOAD(N) \
+    long long D[N][N]; \
+    for (int i=0;i<N;i++) \
+        for (int j=0;j<N;j++) D[i][j] = dm_get(d, i, j);
+
+/* dp sur la pile */
+#define HK_FIXED_STACK(N) \
+static long long held_karp_fixed_##N(const DistMatrix *d) { \
+    HK_FIXED_LOAD(N) \
+    long long dp[(1 << (N-1)) * (N-1)]; \
+    HK_FIXED_BODY(N) \
+    return best; \
+}
+
+/* dp sur le tas (trop grand pour la pile) */
+#define HK_FIXED_HEAP(N) \
+static long long held_karp_fixed_##N(const DistMatrix *d) { \
+    HK_FIXED_LOAD(N) \
+    long long *dp = tsp_alloc(d->alloc, ((size_t)1 << (N-1)) * (N-1) * sizeof(long long)); \
+    if (!dp) return held_karp(d); \
+    HK_FIXED_BODY(N) \
+    tsp_free(d->alloc, dp); \
+    return best; \
+}
+
+HK_FIXED_STACK(4)  HK_FIXED_STACK(5)  HK_FIXED_STACK(6)  HK_FIXED_STACK(7)
+HK_FIXED_STACK(8)  HK_FIXED_STACK(9)  HK_FIXED_STACK(10) HK_FIXED_STACK(11)
+HK_FIXED_STACK(12) HK_FIXED_HEAP(13)  HK_FIXED_HEAP(14)  HK_FIXED_HEAP(15)
+HK_FIXED_HEAP(16)
+
+typedef long long (*hk_fixed_fn)(const DistMatrix *d);
+
+static const hk_fixed_fn held_karp_fixed_table[HK_FIXED_MAX_N + 1] = {
+    [4] = held_karp_fixed_4,   [5] = held_karp_fixed_5,   [6] = held_karp_fixed_6,
+    [7] = held_karp_fixed_7,   [8] = held_karp_fixed_8,   [9] = held_karp_fixed_9,
+    [10] = held_karp_fixed_10, [11] = held_karp_fixed_11, [12] = held_karp_fixed_12,
+    [13] = held_karp_fixed_13, [14] = held_karp_fixed_14, [15] = held_karp_fixed_15,
+    [16] = held_karp_fixed_16,
+};
+
+/* Choisit la version spécialisée pour d->n, sinon la version générique */
+long long held_karp_fixed(const DistMatrix *d) {
+    int n = d->n;
+    if (n >= HK_FIXED_MIN_N && n <= HK_FIXED_MAX_N) return held_karp_fixed_table[n](d);
+    return held_karp(d);
+}
+
+/* ---------- Lecture de fichiers TSPLIB ---------- */
+
+/* Lecture en flux (ligne par ligne, puis jeton par jeton pour les poids): le fichier n'est
+ * jamais chargé en entier. Formats pris en charge:
+ *   EDGE_WEIGHT_TYPE: EUC_2D, CEIL_2D, ATT, GEO (NODE_COORD_SECTION)
+ *                     EXPLICIT avec EDGE_WEIGHT_FORMAT FULL_MATRIX, UPPER_ROW, LOWER_ROW,
+ *                     UPPER_DIAG_ROW, LOWER_DIAG_ROW (EDGE_WEIGHT_SECTION)
+ * Les instances à coordonnées restent paresseuses: pas de matrice n x n, les distances sont
+ * calculées par inst_dist (instance_to_matrix la construit à la demande pour les petits n).
+ */
+
+#define TSPLIB_LINE 512
+#define TSPLIB_PI 3.141592    /* valeur imposée par la spécification TSPLIB pour GEO */
+
+/* Optima connus (TSPLIB) pour vérifier les solveurs sur des fichiers réels */
+typedef struct { const char *name; long long opt; } TsplibOptimum;
+
+static const TsplibOptimum tsplib_optima[] = {
+    { "burma14", 3323 }, { "ulysses16", 6859 }, { "gr17", 2085 }, { "gr21", 2707 },
+    { "ulysses22", 7013 }, { "gr24", 1272 }, { "fri26", 937 }, { "bayg29", 1610 },
+    { "bays29", 2020 }, { "dantzig42", 699 }, { "swiss42", 1273 }, { "att48", 10628 },
+    { "gr48", 5046 }, { "hk48", 11461 }, { "eil51", 426 }, { "berlin52", 7542 },
+    { "brazil58", 25395 }, { "st70", 675 }, { "eil76", 538 }, { "pr76", 108159 },
+    { "gr96", 55209 }, { "rat99", 1211 }, { "kroA100", 21282 }, { "kroB100", 22141 },
+    { "kroC100", 20749 }, { "kroD100", 21294 }, { "kroE100", 22068 }, { "rd100", 7910 },
+    { "eil101", 629 }, { "lin105", 14379 }, { "pr107", 44303 }, { "pr124", 59030 },
+    { "ch130", 6110 }, { "pr136", 96772 }, { "ch150", 6528 }, { "a280", 2579 },
+    { "pcb442", 50778 }, { "att532", 27686 }, { "rat783", 8806 }, { "pr1002", 259045 },
+    { "pr2392", 378032 },
+    { "br17", 39 }, { "ftv33", 1286 }, { "ftv35", 1473 }, { "p43", 5620 },
+    { "ry48p", 14422 }, { "ft53", 6905 },
+};
+
+/* Optimum connu pour ce nom d'instance, -1 si inconnu */
+long long tsplib_known_optimum(const char *name) {
+    int m = sizeof(tsplib_optima) / sizeof(tsplib_optima[0]);
+    for (int i=0;i<m;i++) if (strcmp(tsplib_optima[i].name, name) == 0) return tsplib_optima[i].opt;
+    return -1;
+}
+
+/* Découpe "CLE : VALEUR" (espaces autour de ':' tolérés). Renvoie la valeur ou NULL. */
+static char *tsplib_split(char *line, char **key) {
+    char *p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    *key = p;
+    char *colon = strchr(p, ':');
+    char *end = colon ? colon : p + strlen(p);
+    while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\n' || end[-1] == '\r')) end--;
+    char *val = NULL;
+    if (colon) {
+        val = colon + 1;
+        while (*val == ' ' || *val == '\t') val++;
+        char *ve = val + strlen(val);
+        while (ve > val && (ve[-1] == ' ' || ve[-1] == '\t' || ve[-1] == '\n' || ve[-1] == '\r')) ve--;
+        *ve = '\0';
+    }
+    *end = '\0';
+    return val;
+}
+
+/* Coordonnée TSPLIB GEO (DDD.MM) -> radians. La partie entière est tronquée (comme Concorde). */
+static double tsplib_geo_rad(double v) {
+    int deg = (int)v;
+    double min = v - deg;
+    return TSPLIB_PI * (deg + 5.0 * min / 3.0) / 180.0;
+}
+
+void tsplib_free(TsplibProblem *P) {
+    dm_free(P->matrix);
+    tsp_free(P->inst.alloc, P->inst.x);
+    tsp_free(P->inst.alloc, P->inst.y);
+    memset(P, 0, sizeof(*P));
+}
+
+/* Lit une instance TSPLIB depuis un flux déjà ouvert, jusqu'à la ligne EOF (ou la fin du flux):
+ * plusieurs instances peuvent se suivre dans le même flux (mode service).
+ * src nomme la source dans les messages. Renvoie 0 si succès, -1 sinon (message sur stderr).
+ */
+int tsplib_read_stream(const TspAllocator *A, FILE *f, const char *src, TsplibProblem *P) {
+    memset(P, 0, sizeof(*P));
+    P->inst.alloc = A;
+    char line[TSPLIB_LINE];
+    char wtype[32] = "", wformat[32] = "";
+    int n = 0, ok = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        char *key;
+        char *val = tsplib_split(line, &key);
+        if (*key == '\0') continue;
+
+        if (val) {
+            if (!strcmp(key, "NAME")) snprintf(P->name, sizeof(P->name), "%s", val);
+            else if (!strcmp(key, "TYPE")) P->asymmetric = !strcmp(val, "ATSP");
+            else if (!strcmp(key, "DIMENSION")) n = atoi(val);
+            else if (!strcmp(key, "EDGE_WEIGHT_TYPE")) snprintf(wtype, sizeof(wtype), "%s", val);
+            else if (!strcmp(key, "EDGE_WEIGHT_FORMAT")) snprintf(wformat, sizeof(wformat), "%s", val);
+            continue;
+        }
+        if (!strcmp(key, "EOF")) break;
+        if (n <= 0) {
+            fprintf(stderr, "%s: section %s avant DIMENSION\n", src, key);
+            break;
+        }
+        P->inst.n = n;
+
+        if (!strcmp(key, "NODE_COORD_SECTION")) {
+            if (!strcmp(wtype, "EUC_2D")) P->inst.type = TSP_EUC_2D;
+            else if (!strcmp(wtype, "CEIL_2D")) P->inst.type = TSP_CEIL_2D;
+            else if (!strcmp(wtype, "ATT")) P->inst.type = TSP_ATT;
+            else if (!strcmp(wtype, "GEO")) P->inst.type = TSP_GEO;
+            else {
+                fprintf(stderr, "%s: EDGE_WEIGHT_TYPE %s non supporte\n", src, wtype);
+                break;
+            }
+            P->inst.x = tsp_alloc(A, n * sizeof(double));
+            P->inst.y = tsp_alloc(A, n * sizeof(double));
+            if (!P->inst.x || !P->inst.y) {
+                fprintf(stderr, "%s: memoire insuffisante (n=%d)\n", src, n);
+                break;
+            }
+            int read = 0;
+            for (int i=0; i<n; i++) {
+                int id;
+                double x, y;
+                if (fscanf(f, "%d %lf %lf", &id, &x, &y) != 3 || id < 1 || id > n) break;
+                if (P->inst.type == TSP_GEO) { x = tsplib_geo_rad(x); y = tsplib_geo_rad(y); }
+                P->inst.x[id-1] = x;
+                P->inst.y[id-1] = y;
+                read++;
+            }
+            if (read != n) {
+                fprintf(stderr, "%s: NODE_COORD_SECTION incomplete (%d/%d)\n", src, read, n);
+                break;
+            }
+            ok = 1;
+        } else if (!strcmp(key, "EDGE_WEIGHT_SECTION")) {
+            if (strcmp(wtype, "EXPLICIT")) {
+                fprintf(stderr, "%s: EDGE_WEIGHT_SECTION sans EDGE_WEIGHT_TYPE EXPLICIT\n", src);
+                break;
+            }
+            int full = !strcmp(wformat, "FULL_MATRIX");
+            int upper = !strcmp(wformat, "UPPER_ROW") || !strcmp(wformat, "UPPER_DIAG_ROW");
+            int lower = !strcmp(wformat, "LOWER_ROW") || !strcmp(wformat, "LOWER_DIAG_ROW");
+            int diag = !strcmp(wformat, "UPPER_DIAG_ROW") || !strcmp(wformat, "LOWER_DIAG_ROW");
+            if (!full && !upper && !lower) {
+                fprintf(stderr, "%s: EDGE_WEIGHT_FORMAT %s non supporte\n", src, wformat);
+                break;
+            }
+            /* lecture en 64 bits, puis réduction au type le plus étroit */
+            DistMatrix *d = dm_alloc(A, n, LLONG_MAX);
+            if (!d) {
+                fprintf(stderr, "%s: memoire insuffisante (n=%d)\n", src, n);
+                break;
+            }
+            P->matrix = d;
+            int bad = 0;
+            for (int i=0; i<n && !bad; i++) {
+                int j0 = full ? 0 : upper ? (diag ? i : i+1) : 0;
+                int j1 = full ? n-1 : upper ? n-1 : (diag ? i : i-1);
+                for (int j=j0; j<=j1; j++) {
+                    long long w;
+                    if (fscanf(f, "%lld", &w) != 1) { bad = 1; break; }
+                    dm_set(d, i, j, w);
+                    if (!full) dm_set(d, j, i, w);
+                }
+            }
+            if (bad) {
+                fprintf(stderr, "%s: EDGE_WEIGHT_SECTION incomplete\n", src);
+                break;
+            }
+            for (int i=0;i<n;i++) dm_set(d, i, i, 0);
+            P->matrix = dm_narrow(d);
+            P->inst.d = P->matrix;
+            ok = 1;
+        }
+        /* autres sections (DISPLAY_DATA_SECTION, ...) ignorées: leurs lignes n'ont pas de ':' */
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: aucune donnee exploitable\n", src);
+        tsplib_free(P);
+        return -1;
+    }
+    if (P->name[0] == '\0') snprintf(P->name, sizeof(P->name), "%s", src);
+    return 0;
+}
+
+/* Lit un fichier TSPLIB. Renvoie 0 si succès, -1 sinon (message sur stderr). */
+int tsplib_read(const TspAllocator *A, const char *path, TsplibProblem *P) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Impossible d'ouvrir %s\n", path);
+        return -1;
+    }
+    int r = tsplib_read_stream(A, f, path, P);
+    fclose(f);
+    return r;
+}
+
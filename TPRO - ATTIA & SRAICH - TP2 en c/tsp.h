@@ -0,0 +1,247 @@
+/* tsp.h
+ * Bibliothèque TSP: méthodes exactes (permutations, Held-Karp et ses variantes), bornes
+ * inférieures, heuristiques (2-opt / Or-opt, Lin-Kernighan itéré), lecture TSPLIB.
+ * Compilation: make (libtsp.a, libtsp.so et le programme de comparaison tsp_compare)
+ *
+ * Réentrante: aucune variable globale modifiable. Chaque fonction ne travaille que sur ses
+ * arguments, plusieurs appels peuvent donc tourner en parallèle (sur une même matrice en
+ * lecture seule si besoin).
+ * - La mémoire vient d'un TspAllocator fourni par l'appelant (NULL: malloc/free). Une matrice
+ *   ou une instance retient l'allocateur qui l'a créée; les solveurs l'utilisent pour leurs
+ *   tableaux de travail et les résultats qu'ils renvoient. L'allocateur doit vivre plus
+ *   longtemps que les objets créés, et accepter des appels concurrents si ceux-ci sont
+ *   partagés entre threads (tsp_lin_kernighan alloue depuis ses threads).
+ * - Le hasard des générateurs vient d'un TspContext (un par thread).
+ */
+
+#ifndef TSP_H
+#define TSP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TSP_API_VERSION 1   /* incrémentée à chaque changement incompatible de ce fichier */
+
+#if defined(_WIN32) && defined(TSP_SHARED)
+#ifdef TSP_BUILD
+#define TSP_API __declspec(dllexport)
+#else
+#define TSP_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define TSP_API __attribute__((visibility("default")))
+#else
+#define TSP_API
+#endif
+
+#define INFLL LLONG_MAX/4
+
+/* ---------- Allocation et contexte ---------- */
+
+/* alloc: bloc de bytes octets aligné sur align (puissance de 2, <= 64), NULL si échec.
+ * release: libère un bloc rendu par alloc (NULL accepté). user est transmis tel quel.
+ */
+typedef struct {
+    void *(*alloc)(void *user, size_t bytes, size_t align);
+    void (*release)(void *user, void *p);
+    void *user;
+} TspAllocator;
+
+/* État des générateurs d'instances aléatoires */
+typedef struct {
+    TspAllocator alloc;    /* allocateur des objets générés */
+    unsigned rng;          /* xorshift32, jamais nul */
+} TspContext;
+
+/* Allocateur malloc/free et graine (0 remplacé par 1) */
+TSP_API void tsp_context_init(TspContext *ctx, unsigned seed);
+TSP_API unsigned tsp_rand(TspContext *ctx);
+
+/* Allocation avec A (NULL: allocateur par défaut). Sert aussi à libérer les tableaux
+ * renvoyés par la bibliothèque (build_neighbor_lists, ...) avec l'allocateur de l'objet source.
+ */
+TSP_API void *tsp_alloc(const TspAllocator *A, size_t bytes);
+TSP_API void tsp_free(const TspAllocator *A, void *p);
+
+/* ---------- Matrice de distances contiguë ---------- */
+
+typedef struct {
+    int n;
+    int stride;        /* éléments par ligne (ligne = multiple de 64 octets) */
+    int width;         /* octets par élément: 1, 2, 4 ou 8 */
+    void *data;        /* data[i*stride + j] = d(i,j) */
+    void *data_t;      /* transposée: data_t[j*stride + i] = d(i,j), ou NULL */
+    const TspAllocator *alloc;   /* allocateur de data / data_t (NULL: défaut) */
+} DistMatrix;
+
+static inline long long dm_load(const void *base, int width, size_t idx) {
+    switch (width) {
+    case 1: return ((const uint8_t *)base)[idx];
+    case 2: return ((const uint16_t *)base)[idx];
+    case 4: return ((const uint32_t *)base)[idx];
+    default: return ((const int64_t *)base)[idx];
+    }
+}
+
+static inline long long dm_get(const DistMatrix *M, int i, int j) {
+    return dm_load(M->data, M->width, (size_t)i * M->stride + j);
+}
+
+static inline void dm_store(void *base, int width, size_t idx, long long v) {
+    switch (width) {
+    case 1: ((uint8_t *)base)[idx] = (uint8_t)v; break;
+    case 2: ((uint16_t *)base)[idx] = (uint16_t)v; break;
+    case 4: ((uint32_t *)base)[idx] = (uint32_t)v; break;
+    default: ((int64_t *)base)[idx] = v; break;
+    }
+}
+
+/* Écrit d(i,j); la copie transposée, si elle existe, reste à jour */
+static inline void dm_set(DistMatrix *M, int i, int j, long long v) {
+    dm_store(M->data, M->width, (size_t)i * M->stride + j, v);
+    if (M->data_t) dm_store(M->data_t, M->width, (size_t)j * M->stride + i, v);
+}
+
+/* Matrice n x n à 0, valeurs futures dans [0, max_value]; NULL si mémoire insuffisante */
+TSP_API DistMatrix *dm_alloc(const TspAllocator *A, int n, long long max_value);
+TSP_API void dm_free(DistMatrix *M);
+/* Copie transposée (colonnes contiguës), tenue à jour ensuite par dm_set; 0 ou -1.
+ * held_karp_simd la lit si elle existe, sinon en fait une copie privée le temps de l'appel. */
+TSP_API int dm_build_transpose(DistMatrix *M);
+TSP_API DistMatrix *dm_narrow(DistMatrix *M);
+TSP_API int dm_is_symmetric(const DistMatrix *M);
+
+/* Distances dans [1, max_dist], diagonale 0 */
+TSP_API DistMatrix *generate_random_complete_graph(TspContext *ctx, int n, long long max_dist);
+TSP_API DistMatrix *generate_random_asymmetric_graph(TspContext *ctx, int n, long long max_dist);
+TSP_API long long cycle_cost_from_perm(const DistMatrix *d, int *perm, int m);
+
+/* ---------- Instances: matrice complète ou coordonnées ---------- */
+
+enum { TSP_EUC_2D = 0, TSP_CEIL_2D, TSP_ATT, TSP_GEO };
+
+typedef struct {
+    int n;
+    const DistMatrix *d;   /* matrice complète, ou NULL */
+    double *x, *y;     /* coordonnées si d == NULL (GEO: latitude/longitude en radians) */
+    int type;          /* TSP_EUC_2D, TSP_CEIL_2D, TSP_ATT ou TSP_GEO */
+    const TspAllocator *alloc;   /* allocateur des coordonnées et des tableaux de travail */
+} TspInstance;
+
+#define MAX_COORD 1000000.0  /* coordonnées aléatoires dans [0, MAX_COORD[ */
+
+TSP_API TspInstance instance_from_matrix(const DistMatrix *d);
+TSP_API DistMatrix *instance_to_matrix(const TspInstance *I);
+TSP_API TspInstance generate_random_euclidean_instance(TspContext *ctx, int n);
+TSP_API void free_instance_coords(TspInstance *I);
+TSP_API long long tour_cost(const TspInstance *I, const int *tour);
+TSP_API long long nearest_neighbor_cost(const TspInstance *I);
+
+/* ---------- Méthodes exactes ---------- */
+
+TSP_API long long tsp_exact(const DistMatrix *d);
+TSP_API long long tsp_exact_heap(const DistMatrix *d);
+
+#define HK_MAX_BITS 62         /* villes hors départ des variantes par couches */
+#define HK_OOC_DIR "."         /* dossier des fichiers de couches par défaut */
+#define HK_OOC_BUFFER (1 << 20)  /* octets de tampon par flux du calcul hors mémoire */
+#define HK_FIXED_MIN_N 4
+#define HK_FIXED_MAX_N 16
+
+TSP_API long long held_karp_dp(const DistMatrix *d, long long *dp);
+TSP_API long long held_karp(const DistMatrix *d);
+TSP_API long long held_karp_layered(const DistMatrix *d, int *tour, size_t *peak_bytes);
+TSP_API long long held_karp_mitm(const DistMatrix *d, size_t *peak_bytes);
+TSP_API long long held_karp_out_of_core(const DistMatrix *d, const char *dir, size_t *peak_disk);
+TSP_API long long held_karp_simd(const DistMatrix *d);
+TSP_API const char *held_karp_simd_kernel(void);
+TSP_API long long held_karp_fixed(const DistMatrix *d);
+
+/* ---------- Contraintes (précédences, fenêtres de temps) ---------- */
+
+#define CONSTRAINED_MAX_N 32
+
+typedef struct {
+    uint32_t *before;     /* before[j]: villes (bits) à visiter avant j, NULL = aucune précédence */
+    long long *ready;     /* ready[j]: début de fenêtre, NULL = pas de fenêtres */
+    long long *due;       /* due[j]: fin de fenêtre (due[0]: retour au dépôt) */
+    const TspAllocator *alloc;   /* allocateur des tableaux (free_constraints) */
+} TspConstraints;
+
+/* Codes d'erreur de held_karp_constrained (un makespan est toujours >= 0) */
+#define HKC_INFEASIBLE (-1)    /* aucune tournée ne respecte les contraintes */
+#define HKC_NOMEM (-2)         /* mémoire insuffisante */
+#define HKC_TOO_LARGE (-3)     /* n > CONSTRAINED_MAX_N */
+
+/* Makespan optimal (instant de retour au dépôt) ou l'un des codes HKC_* ci-dessus */
+TSP_API long long held_karp_constrained(const DistMatrix *d, const TspConstraints *C, size_t *states);
+/* Contraintes réalisables tirées au hasard; tableaux à NULL si n > CONSTRAINED_MAX_N
+ * ou mémoire insuffisante */
+TSP_API TspConstraints generate_random_constraints(TspContext *ctx, const DistMatrix *d, int nprec,
+                                                   long long width);
+TSP_API void free_constraints(TspConstraints *C);
+
+/* ---------- Bornes inférieures ---------- */
+
+TSP_API long long one_tree_bound(const TspInstance *I, long long ub);
+TSP_API long long assignment_bound(const DistMatrix *d);
+TSP_API long long tsp_lower_bound(const TspInstance *I, long long ub);
+TSP_API double optimality_gap(long long tour_cost, long long bound);
+
+/* ---------- Heuristiques (instances symétriques uniquement) ---------- */
+
+#define NEIGHBOR_K 10        /* taille des listes de candidats (k plus proches voisins) */
+#define LK_MAX_DEPTH 5
+
+/* Listes de voisins (n*k entiers, à libérer par tsp_free(I->alloc, ...)) */
+TSP_API int *build_neighbor_lists(const TspInstance *I, int k);
+TSP_API void nearest_neighbor_tour(const TspInstance *I, const int *neigh, int k, int *tour);
+TSP_API void local_search_2opt_oropt(const TspInstance *I, int *tour, const int *neigh, int k);
+TSP_API long long tsp_local_search(const TspInstance *I, int *tour);
+
+typedef struct {
+    double time;       /* secondes depuis le début */
+    long long cost;
+    int thread;
+} LkEvent;
+
+typedef struct {
+    long long cost;
+    int *tour;             /* meilleure tournée (n villes) */
+    LkEvent *timeline;     /* améliorations successives de la meilleure tournée */
+    int ntimeline;
+    long long kicks;       /* perturbations effectuées (tous threads) */
+    const TspAllocator *alloc;
+} LkResult;
+
+TSP_API LkResult tsp_lin_kernighan(const TspInstance *I, double time_budget, int nthreads, unsigned seed);
+TSP_API void free_lk_result(LkResult *R);
+
+/* Horloge murale monotone (secondes) */
+TSP_API double wall_seconds(void);
+
+/* ---------- Fichiers TSPLIB ---------- */
+
+typedef struct {
+    char name[64];
+    int asymmetric;           /* TYPE: ATSP */
+    DistMatrix *matrix;       /* poids explicites (inst.d), ou NULL */
+    TspInstance inst;
+} TsplibProblem;
+
+TSP_API long long tsplib_known_optimum(const char *name);
+TSP_API int tsplib_read_stream(const TspAllocator *A, FILE *f, const char *src, TsplibProblem *P);
+TSP_API int tsplib_read(const TspAllocator *A, const char *path, TsplibProblem *P);
+TSP_API void tsplib_free(TsplibProblem *P);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,319 @@
+// taquin.c
+// A* / WA* engine of the taquin library (interface: taquin.h). Build: make
+//
+// No mutable global state: the goal lives in the TaquinContext, each search keeps its heap
+// and its nodes in a local Search struct, and all memory goes through the context allocator.
+
+#define _POSIX_C_SOURCE 200809L   // clock_gettime, posix_memalign
+#define TAQUIN_BUILD
+#include "taquin.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// Nodes are carved out of blocks of NODE_BLOCK, released together at the end of the search
+#define NODE_BLOCK 4096
+
+struct noeud {
+    conf m;
+    int g;        // g(x)
+    int h;        // h(x)
+    double cout;  // f(x) = g(x) + p*h(x)
+    struct noeud *pere;
+};
+
+// Priority Queue (Min-Heap)
+typedef struct {
+    struct noeud **tab;
+    int nbElem;
+    int capacity;
+} Heap;
+
+typedef struct NodeBlock {
+    struct NodeBlock *next;
+    int used;
+    struct noeud nodes[NODE_BLOCK];
+} NodeBlock;
+
+// State of one search
+typedef struct {
+    const TaquinContext *ctx;
+    Heap h;
+    NodeBlock *blocks;     // most recent block first
+} Search;
+
+// --- Allocation ---
+
+static void *default_alloc(void *user, size_t bytes, size_t align) {
+    (void)user;
+#ifdef _WIN32
+    return _aligned_malloc(bytes, align);
+#else
+    if (align <= 2 * sizeof(void *)) return malloc(bytes);
+    void *p = NULL;
+    if (posix_memalign(&p, align, bytes) != 0) return NULL;
+    return p;
+#endif
+}
+
+static void default_release(void *user, void *p) {
+    (void)user;
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+static void *ctx_alloc(const TaquinContext *ctx, size_t bytes) {
+    return ctx->alloc.alloc(ctx->alloc.user, bytes, 2 * sizeof(void *));
+}
+
+static void ctx_free(const TaquinContext *ctx, void *p) {
+    if (p) ctx->alloc.release(ctx->alloc.user, p);
+}
+
+static struct noeud *node_new(Search *S) {
+    NodeBlock *b = S->blocks;
+    if (!b || b->used == NODE_BLOCK) {
+        b = ctx_alloc(S->ctx, sizeof(NodeBlock));
+        if (!b) return NULL;
+        b->next = S->blocks;
+        b->used = 0;
+        S->blocks = b;
+    }
+    return &b->nodes[b->used++];
+}
+
+// Gives back the node just returned by node_new
+static void node_drop_last(Search *S) {
+    S->blocks->used--;
+}
+
+static void search_free(Search *S) {
+    while (S->blocks) {
+        NodeBlock *next = S->blocks->next;
+        ctx_free(S->ctx, S->blocks);
+        S->blocks = next;
+    }
+    ctx_free(S->ctx, S->h.tab);
+}
+
+// --- Context ---
+
+void taquin_context_init(TaquinContext *ctx) {
+    static const conf standard = {
+        {1, 2, 3, 4},
+        {5, 6, 7, 8},
+        {9, 10, 11, 12},
+        {13, 14, 15, 0}
+    };
+    ctx->alloc.alloc = default_alloc;
+    ctx->alloc.release = default_release;
+    ctx->alloc.user = NULL;
+    ctx->maxNodes = MAX_NODES;
+    taquin_set_goal(ctx, (char (*)[4])standard);
+}
+
+void taquin_set_goal(TaquinContext *ctx, conf goal) {
+    memcpy(ctx->but, goal, sizeof(conf));
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            int val = goal[i][j];
+            ctx->goalI[val] = i;
+            ctx->goalJ[val] = j;
+        }
+    }
+}
+
+// --- Heap Functions ---
+
+static void swap(struct noeud **a, struct noeud **b) {
+    struct noeud *tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void heapifyUp(Heap *h, int idx) {
+    while (idx > 0) {
+        int p = (idx - 1) / 2;
+        if (h->tab[idx]->cout < h->tab[p]->cout) {
+            swap(&h->tab[idx], &h->tab[p]);
+            idx = p;
+        } else break;
+    }
+}
+
+static void heapifyDown(Heap *h, int idx) {
+    while (1) {
+        int l = 2 * idx + 1;
+        int r = 2 * idx + 2;
+        int minIdx = idx;
+        if (l < h->nbElem && h->tab[l]->cout < h->tab[minIdx]->cout) minIdx = l;
+        if (r < h->nbElem && h->tab[r]->cout < h->tab[minIdx]->cout) minIdx = r;
+        if (minIdx != idx) {
+            swap(&h->tab[idx], &h->tab[minIdx]);
+            idx = minIdx;
+        } else break;
+    }
+}
+
+static void HeapPush(Heap *h, struct noeud *n) {
+    if (h->nbElem >= h->capacity) return;
+    h->tab[h->nbElem] = n;
+    heapifyUp(h, h->nbElem);
+    h->nbElem++;
+}
+
+static struct noeud* HeapPop(Heap *h) {
+    if (h->nbElem == 0) return NULL;
+    struct noeud *root = h->tab[0];
+    h->nbElem--;
+    if (h->nbElem > 0) {
+        h->tab[0] = h->tab[h->nbElem];
+        heapifyDown(h, 0);
+    }
+    return root;
+}
+
+// --- Heuristics ---
+
+int h_misplaced(const TaquinContext *ctx, conf m) {
+    int count = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (m[i][j] != 0 && m[i][j] != ctx->but[i][j]) count++;
+        }
+    }
+    return count;
+}
+
+int h_manhattan(const TaquinContext *ctx, conf m) {
+    int dist = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            int val = m[i][j];
+            if (val != 0) {
+                dist += abs(i - ctx->goalI[val]) + abs(j - ctx->goalJ[val]);
+            }
+        }
+    }
+    return dist;
+}
+
+// --- Utils ---
+
+static double wall_seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+static void pos_vide(conf m, int *iv, int *jv) {
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            if (m[i][j] == 0) { *iv = i; *jv = j; return; }
+        }
+    }
+}
+
+static int test_conf(conf m1, conf m2) {
+    return memcmp(m1, m2, sizeof(conf)) == 0;
+}
+
+static int exists_in_path(struct noeud *v, struct noeud *ch) {
+    struct noeud *p = ch;
+    while (p != NULL) {
+        if (test_conf(v->m, p->m)) return 1;
+        p = p->pere;
+    }
+    return 0;
+}
+
+// --- Search ---
+
+Metrics run_WA_star(const TaquinContext *ctx, conf initial, int useManhattan, double p_weight) {
+    Search S;
+    S.ctx = ctx;
+    S.blocks = NULL;
+    S.h.nbElem = 0;
+    S.h.capacity = ctx->maxNodes;
+    S.h.tab = ctx_alloc(ctx, (size_t)ctx->maxNodes * sizeof(struct noeud *));
+
+    Metrics met = {0, 0, 0.0, 0, TAQUIN_UNSOLVED};
+    double start = wall_seconds();
+
+    struct noeud *root = S.h.tab ? node_new(&S) : NULL;
+    if (!root) {
+        search_free(&S);
+        met.status = TAQUIN_NOMEM;
+        return met;
+    }
+    memcpy(root->m, initial, sizeof(conf));
+    root->g = 0;
+    root->h = useManhattan ? h_manhattan(ctx, root->m) : h_misplaced(ctx, root->m);
+    root->cout = root->g + p_weight * root->h;
+    root->pere = NULL;
+
+    HeapPush(&S.h, root);
+
+    while (S.h.nbElem > 0) {
+        if (S.h.nbElem > met.maxFrontier) met.maxFrontier = S.h.nbElem;
+
+        struct noeud *e = HeapPop(&S.h);
+        met.nodesExpanded++;
+
+        if (test_conf(e->m, (char (*)[4])ctx->but)) {
+            met.solutionDepth = e->g;
+            met.status = TAQUIN_SOLVED;
+            break;
+        }
+
+        int iv = 0, jv = 0;
+        pos_vide(e->m, &iv, &jv);
+
+        int di[] = {-1, 1, 0, 0};
+        int dj[] = {0, 0, -1, 1};
+
+        for (int k = 0; k < 4; k++) {
+            int ni = iv + di[k];
+            int nj = jv + dj[k];
+
+            if (ni >= 0 && ni < 4 && nj >= 0 && nj < 4) {
+                struct noeud *v = node_new(&S);
+                if (!v) {
+                    met.status = TAQUIN_NOMEM;
+                    goto done;
+                }
+                memcpy(v->m, e->m, sizeof(conf));
+                v->m[iv][jv] = e->m[ni][nj];
+                v->m[ni][nj] = 0;
+
+                if (!exists_in_path(v, e)) {
+                    v->g = e->g + 1;
+                    v->h = useManhattan ? h_manhattan(ctx, v->m) : h_misplaced(ctx, v->m);
+                    v->cout = v->g + p_weight * v->h;
+                    v->pere = e;
+                    HeapPush(&S.h, v);
+                } else {
+                    node_drop_last(&S);
+                }
+            }
+        }
+    }
+
+done:
+    met.timeTaken = wall_seconds() - start;
+    search_free(&S);
+    return met;
+}
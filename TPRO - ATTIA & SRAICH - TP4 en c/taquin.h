@@ -0,0 +1,85 @@
+// taquin.h
+// 15-puzzle solver library: A* / WA* with a binary heap, misplaced-tiles and Manhattan heuristics.
+// Build: make (libtaquin.a, libtaquin.so and the benchmark programs)
+//
+// Re-entrant: no mutable global state. A search only touches its arguments and the
+// TaquinContext it is given, so several searches can run concurrently (one context per
+// thread, or a shared one used read-only).
+// - Memory comes from the context allocator (taquin_context_init: malloc/free). It must
+//   accept concurrent calls if the context is shared between threads.
+// - Every node of a search is released before run_WA_star returns.
+
+#ifndef TAQUIN_H
+#define TAQUIN_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TAQUIN_API_VERSION 1   // bumped on every incompatible change to this file
+
+#if defined(_WIN32) && defined(TAQUIN_SHARED)
+#ifdef TAQUIN_BUILD
+#define TAQUIN_API __declspec(dllexport)
+#else
+#define TAQUIN_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define TAQUIN_API __attribute__((visibility("default")))
+#else
+#define TAQUIN_API
+#endif
+
+// Default frontier capacity (nodes beyond it are dropped, as in the original benchmark)
+#define MAX_NODES 1000000
+
+// Types
+typedef char conf[4][4];
+
+// alloc: block of bytes bytes aligned on align (power of 2), NULL on failure.
+// release: frees a block returned by alloc (NULL accepted). user is passed through.
+typedef struct {
+    void *(*alloc)(void *user, size_t bytes, size_t align);
+    void (*release)(void *user, void *p);
+    void *user;
+} TaquinAllocator;
+
+typedef struct {
+    TaquinAllocator alloc;
+    conf but;              // goal configuration
+    int goalI[16];         // row of each tile in but (filled by taquin_set_goal)
+    int goalJ[16];
+    int maxNodes;          // frontier capacity
+} TaquinContext;
+
+enum { TAQUIN_SOLVED = 0, TAQUIN_UNSOLVED, TAQUIN_NOMEM };
+
+// Metrics
+typedef struct {
+    long nodesExpanded;
+    int maxFrontier;
+    double timeTaken;      // wall-clock seconds
+    int solutionDepth;
+    int status;            // TAQUIN_SOLVED, TAQUIN_UNSOLVED (frontier exhausted) or TAQUIN_NOMEM
+} Metrics;
+
+// malloc/free allocator, standard goal (1..15 then the blank), MAX_NODES
+TAQUIN_API void taquin_context_init(TaquinContext *ctx);
+TAQUIN_API void taquin_set_goal(TaquinContext *ctx, conf goal);
+
+// --- Heuristics ---
+TAQUIN_API int h_misplaced(const TaquinContext *ctx, conf m);
+TAQUIN_API int h_manhattan(const TaquinContext *ctx, conf m);
+
+// --- Search ---
+// f(x) = g(x) + p_weight * h(x); p_weight = 1 gives A*
+TAQUIN_API Metrics run_WA_star(const TaquinContext *ctx, conf initial, int useManhattan,
+                               double p_weight);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif